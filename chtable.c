@@ -56,6 +56,9 @@ xlate_for_csieve (machine_t *M)
 /*   fprintf(DBG, "csieve Calling xlate_bb at %lx\n", M->fixregs.eip); */
   M->comming_from_call_indirect = true;
   entry_node = xlate_bb(M);
+#ifdef PROFILE_XLATE_PHASES
+  unsigned long long xp_t = read_timer();
+#endif
 
   bucket = (bucket_entry *) CSIEVE_HASH_BUCKET(M->chash_table, ((unsigned long)entry_node->src_bb_eip));
   //  fprintf(DBG, "Hash bucket start at %lx, this = %lx\n", M->hash_table, bucket);
@@ -100,6 +103,9 @@ xlate_for_csieve (machine_t *M)
 #ifdef PROFILE
   M->ptState->hash_nodes_cnt++;
 #endif
+#ifdef PROFILE_XLATE_PHASES
+  xp_phase(M, XP_SIEVE, xp_t);
+#endif
 }
 
 INLINE void 
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2005, Johns Hopkins University and The EROS Group, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ *  * Neither the name of the Johns Hopkins University, nor the name
+ *    of The EROS Group, LLC, nor the names of their contributors may
+ *    be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/***********************************************************************
+               Decode cache that survives cache flushes
+************************************************************************/
+
+/* For each guest page that code was translated from, M->dcache keeps a
+   compact record of each instruction on it that do_decode_fast does
+   not take: its length, its emitter, and the few other fields of the
+   decode that the emitters it is kept for look at (the branch target,
+   in ds->immediate, among them). After bb_cache_reinit, decode_run
+   fills M->ibuf from the records instead of decoding again.
+
+   The records of a page are only used while the page sums as it did
+   when they were made. That is checked on the first use of the page
+   after each flush (M->dcache_epoch), and not for each instruction:
+   within an epoch, as for the rest of the cache, nothing checks
+   whether the guest code has changed. Instructions that run onto the
+   next page, and those of other emitters, are not kept. */
+
+/* The emitters of the instructions kept, indexed by rec->kind */
+static const void *const dcache_emitfns[] = {
+  emit_normal, emit_jcond, emit_other_jcond, emit_jmp, emit_call_disp,
+  emit_ret, emit_ret_Iw
+};
+
+#define DCACHE_KINDS  (sizeof(dcache_emitfns) / sizeof(dcache_emitfns[0]))
+#define DCACHE_PROBES 8
+
+/* Fletcher's sum, over the even and the odd words of the page apart:
+   it is taken for every page after each flush, and the four sums do
+   not wait on each other */
+static unsigned long
+dcache_hash(unsigned long page)
+{
+  const unsigned long *p = (const unsigned long *)page;
+  const unsigned long *end = p + PAGE_SIZE / sizeof(*p);
+  unsigned long a0 = 0, b0 = 0, a1 = 0, b1 = 0;
+
+  for (; p != end; p += 2) {
+    a0 += p[0];
+    b0 += a0;
+    a1 += p[1];
+    b1 += a1;
+  }
+  return (a0 + b1) ^ (a1 + b0);
+}
+
+/* The records of the page of eip, if there are any that can be used */
+static inline dcache_page *
+dcache_valid_page(machine_t *M, unsigned long eip)
+{
+  dcache_page *pg = &M->dcache[(eip / PAGE_SIZE) & (DCACHE_PAGES - 1)];
+
+  if (pg->page != (eip & ~(PAGE_SIZE - 1)))
+    return NULL;
+  if (pg->epoch != M->dcache_epoch) {
+    if (dcache_hash(pg->page) != pg->sum) {
+      pg->page = 0;
+      return NULL;
+    }
+    pg->epoch = M->dcache_epoch;
+  }
+  return pg;
+}
+
+/* Fill ds from M->dcache if the instruction at M->next_eip has a
+   record. Only the fields that the translation loop and the emitter
+   look at are filled in */
+static inline bool
+dcache_lookup(machine_t *M, decode_t *ds)
+{
+  unsigned long eip = M->next_eip;
+  unsigned long off = (eip & (PAGE_SIZE - 1)) + 1;
+  dcache_page *pg = dcache_valid_page(M, eip);
+  dcache_rec *r;
+  unsigned long i;
+
+  if (pg != NULL)
+    for (i = 0; i < DCACHE_PROBES; i++) {
+      r = &pg->rec[(off + i) & (DCACHE_PAGE_RECS - 1)];
+      if (r->off == off) {
+	ds->decode_eip = eip;
+	ds->instr = (unsigned char *)eip + r->nprefix;
+	ds->pInstr = (unsigned char *)eip + r->len;
+	ds->emitfn = dcache_emitfns[r->kind];
+	ds->pEntry = r->pEntry;
+	ds->flags = r->flags;
+	ds->Group2_Prefix = r->Group2_Prefix;
+	ds->opstate = r->opstate;
+	ds->immediate = r->immediate;
+	ds->imm16 = r->immediate;
+	M->next_eip = eip + r->len;
+#ifdef PROFILE
+	M->ptState->dcache_hits++;
+#endif
+	return true;
+      }
+      if (r->off == 0)
+	break;
+    }
+
+#ifdef PROFILE
+  M->ptState->dcache_misses++;
+#endif
+  return false;
+}
+
+/* Keep a record of ds, just decoded */
+static inline void
+dcache_insert(machine_t *M, decode_t *ds)
+{
+  unsigned long eip = ds->decode_eip;
+  unsigned long len = ds->pInstr - (unsigned char *)eip;
+  unsigned long off = (eip & (PAGE_SIZE - 1)) + 1;
+  dcache_page *pg;
+  dcache_rec *r;
+  unsigned long kind, i;
+
+  if (off - 1 + len > PAGE_SIZE)
+    return;
+  for (kind = 0; kind < DCACHE_KINDS; kind++)
+    if ((void *)ds->emitfn == dcache_emitfns[kind])
+      break;
+  if (kind == DCACHE_KINDS)
+    return;
+
+  pg = dcache_valid_page(M, eip);
+  if (pg == NULL) {
+    /* Take the slot of the page over */
+    pg = &M->dcache[(eip / PAGE_SIZE) & (DCACHE_PAGES - 1)];
+    memset(pg->rec, 0, sizeof(pg->rec));
+    pg->page = eip & ~(PAGE_SIZE - 1);
+    pg->sum = dcache_hash(pg->page);
+    pg->epoch = M->dcache_epoch;
+  }
+
+  for (i = 0; i < DCACHE_PROBES; i++) {
+    r = &pg->rec[(off + i) & (DCACHE_PAGE_RECS - 1)];
+    if ((r->off == 0) || (r->off == off)) {
+      r->off = off;
+      r->len = len;
+      r->nprefix = ds->instr - (unsigned char *)eip;
+      r->kind = kind;
+      r->flags = ds->flags;
+      r->Group2_Prefix = ds->Group2_Prefix;
+      r->opstate = ds->opstate;
+      r->immediate = (ds->emitfn == (void *)emit_ret_Iw) ? ds->imm16 : ds->immediate;
+      r->pEntry = ds->pEntry;
+      return;
+    }
+  }
+}
@@ -65,6 +65,7 @@
 #define debug_show_each_instr_trans  0x0008000u
 #define debug_show_each_trans_instr  0x0010000u
 #define debug_dump_load              0x0020000u
+#define debug_peephole               0x0040000u
 #define debug_thread_init            0x0080000u 
 #define debug_signal_registry        0x0100000u
 #define debug_signal_note            0x0200000u
@@ -35,6 +35,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 #include "switches.h"
 #include "debug.h"
 #include "machine.h"
@@ -46,84 +47,93 @@
 
 /* It simplifies the inline decoder a good bit if we run through and
    precompute which opcodes require a modR/M byte. */
-void
-do_decode_init(FILE *F, const OpCode *table, char *name, unsigned length)
+unsigned
+op_attr(const OpCode *op)
 {
-  unsigned i;
-  fprintf(F, "\nCONST_TABLE OpCode %s [%u] = {\n", name, length);
-  for (i = 0; i < length; i++) {
-    unsigned a;
-    const OpCode *op = &table[i];
-    unsigned attr = op->attr;
-
-    fprintf(F, "  { 0x%xu,  \"%s\",  ",op->index, op->disasm);
+  unsigned a;
+  unsigned attr = op->attr;
 
-    for (a = 0; a < OP_MAXARG; a++) {
-      switch(op->args[a].amode) {
-      case ADDR_E:
-      case ADDR_G:
-      case ADDR_R:
-      case ADDR_C:
-      case ADDR_D:
-      case ADDR_T:
-	attr |= DF_MODRM;
-	break;
-      case ADDR_direct:
-	attr |= DF_Ap;
-	break;
-      case ADDR_imm:
-	{
-	  switch(op->args[a].ainfo) {
-	  case b_mode:
-	    attr |= DF_Ib;
-	    break;
-	  case v_mode:
-	    attr |= DF_Iv;
-	    break;
-	  case w_mode:
-	    attr |= DF_Iw;
-	    break;
-	  default:
-	    assert(0 && "unhandled immediate mode");
-	  }
+  for (a = 0; a < OP_MAXARG; a++) {
+    switch(op->args[a].amode) {
+    case ADDR_E:
+    case ADDR_G:
+    case ADDR_R:
+    case ADDR_C:
+    case ADDR_D:
+    case ADDR_T:
+      attr |= DF_MODRM;
+      break;
+    case ADDR_direct:
+      attr |= DF_Ap;
+      break;
+    case ADDR_imm:
+      {
+	switch(op->args[a].ainfo) {
+	case b_mode:
+	  attr |= DF_Ib;
 	  break;
-	}
-      case ADDR_offset:
-	{
-	  switch(op->args[a].ainfo) {
-	  case b_mode:
-	    attr |= DF_Ob;
-	    break;
-	  case v_mode:
-	    attr |= DF_Ov;
-	    break;
-	  default:
-	    assert(0 && "unhandled offset addr mode");
-	  }
+	case v_mode:
+	  attr |= DF_Iv;
+	  break;
+	case w_mode:
+	  attr |= DF_Iw;
 	  break;
+	default:
+	  assert(0 && "unhandled immediate mode");
 	}
-      case ADDR_jmp:
-	{
-	  switch(op->args[a].ainfo) {
-	  case b_mode:
-	    attr |= DF_Jb;
-	    break;
-	  case v_mode:
-	    attr |= DF_Jv;
-	    break;
-	  default:
-	    assert(0 && "unhandled jump addr mode");
-	  }
+	break;
+      }
+    case ADDR_offset:
+      {
+	switch(op->args[a].ainfo) {
+	case b_mode:
+	  attr |= DF_Ob;
 	  break;
+	case v_mode:
+	  attr |= DF_Ov;
+	  break;
+	default:
+	  assert(0 && "unhandled offset addr mode");
 	}
-      case ADDR_FREG:
 	break;
-      default:
+      }
+    case ADDR_jmp:
+      {
+	switch(op->args[a].ainfo) {
+	case b_mode:
+	  attr |= DF_Jb;
+	  break;
+	case v_mode:
+	  attr |= DF_Jv;
+	  break;
+	default:
+	  assert(0 && "unhandled jump addr mode");
+	}
 	break;
       }
+    case ADDR_FREG:
+      break;
+    default:
+      break;
+    }
+  }
+  return attr;
+}
+
+void
+do_decode_init(FILE *F, const OpCode *table, char *name, unsigned length)
+{
+  unsigned i;
+  fprintf(F, "\nCONST_TABLE OpCode %s [%u] = {\n", name, length);
+  for (i = 0; i < length; i++) {
+    unsigned a;
+    const OpCode *op = &table[i];
+    unsigned attr = op_attr(op);
+
+    fprintf(F, "  { 0x%xu,  \"%s\",  ",op->index, op->disasm);
 
+    for (a = 0; a < OP_MAXARG; a++)
       fprintf(F, "%u, %u,  ",op->args[a].amode, op->args[a].ainfo);
-    }
 
     fprintf(F, "%s,   \"%s\",  %u,  %u },\n",op->emitter_name, 
 	    op->emitter_name, attr, op->flag_effect); 
@@ -132,6 +142,337 @@ do_decode_init(FILE *F, const OpCode *table, char *name, unsigned length)
   fflush(stdout);
 }
 
+/* Bytes of immediates / offsets that follow the modR/M part, for an
+   instruction without any prefixes */
+static unsigned
+imm_bytes(unsigned attr)
+{
+  unsigned n = 0;
+
+  if (attr & DF_Iw)
+    n += 2;
+  if (attr & (DF_Ib|DF_Jb))
+    n += 1;
+  if (attr & DF_Iv)
+    n += 4;
+  if (attr & (DF_Ov|DF_Ob))
+    n += 4;
+  if (attr & (DF_Jv|DF_Ap))
+    n += 4;
+  if (attr & DF_Ap)
+    n += 2;
+  return n;
+}
+
+static bool
+is_normal(const OpCode *op)
+{
+  return ((strcmp(op->emitter_name, "emit_normal") == 0) &&
+	  ((op_attr(op) & DF_UNDEFINED) == 0));
+}
+
+/* Length and class of an opcode for do_decode_fast(), 0 if it has to
+   go through do_decode() */
+static unsigned
+fast_class(const OpCode *op)
+{
+  unsigned attr = op_attr(op);
+  unsigned i, imm;
+
+  if (attr & (DF_PREFIX|DF_UNDEFINED|DF_TABLE|DF_FLOAT|DF_ONE_MORE_LEVEL))
+    return 0;
+
+  if (attr & DF_GROUP) {
+    /* All members must be normal, and of the same length */
+    const OpCode *group = (const OpCode *)op->ptr;
+    imm = imm_bytes(op_attr(&group[0]));
+    for (i = 0; i < 8; i++)
+      if (!is_normal(&group[i]) || (imm_bytes(op_attr(&group[i])) != imm))
+	return 0;
+    return FAST_NORMAL | FAST_MODRM | FAST_GROUP | FAST_IMM(imm);
+  }
+
+  if (!is_normal(op))
+    return 0;
+  return (FAST_NORMAL | ((attr & DF_MODRM) ? FAST_MODRM : 0) |
+	  FAST_IMM(imm_bytes(attr)));
+}
+
+#define Do_fast_init(table, len) do_fast_init(F, table, #table, len);
+
+void
+do_fast_init(FILE *F, const OpCode *table, char *name, unsigned length)
+{
+  unsigned i;
+  fprintf(F, "\nCONST_TABLE unsigned char %s_fast [%u] = {", name, length);
+  for (i = 0; i < length; i++) {
+    if ((i % 16) == 0)
+      fprintf(F, "\n ");
+    fprintf(F, " 0x%02xu,", fast_class(&table[i]));
+  }
+  fprintf(F, "\n};\n");
+  fflush(stdout);
+}
+
+/* Hot decode data. For each table that the decoders walk at speed,
+   <table>_attr[] holds the attributes of its entries and <table>_ptr[]
+   an index into decode_ptrs[], the emitters and tables that entries
+   point to. decode_ptrs_attr[] holds the <table>_attr[] of a pointed-to
+   table, if it has one. The OpCode tables themselves are then only
+   read for disassembly, and by the table walker */
+static const char *ptr_names[256];
+static unsigned n_ptrs;
+static const char *hot_names[32];
+static unsigned n_hot;
+
+static unsigned
+ptr_index(const OpCode *op)
+{
+  unsigned i;
+  for (i = 0; i < n_ptrs; i++)
+    if (strcmp(ptr_names[i], op->emitter_name) == 0)
+      return i;
+  assert(n_ptrs < 256 && "too many emitters and tables for decode_ptrs");
+  ptr_names[n_ptrs] = op->emitter_name;
+  return n_ptrs++;
+}
+
+#define Do_hot_init(table, len) do_hot_init(F, table, #table, len);
+
+void
+do_hot_init(FILE *F, const OpCode *table, char *name, unsigned length)
+{
+  unsigned i;
+
+  fprintf(F, "\nCONST_TABLE unsigned long %s_attr [%u] = {", name, length);
+  for (i = 0; i < length; i++) {
+    if ((i % 8) == 0)
+      fprintf(F, "\n ");
+    fprintf(F, " 0x%06xu,", op_attr(&table[i]));
+  }
+  fprintf(F, "\n};\n");
+
+  fprintf(F, "\nCONST_TABLE unsigned char %s_ptr [%u] = {", name, length);
+  for (i = 0; i < length; i++) {
+    if ((i % 16) == 0)
+      fprintf(F, "\n ");
+    fprintf(F, " %3u,", ptr_index(&table[i]));
+  }
+  fprintf(F, "\n};\n");
+
+  assert(n_hot < 32);
+  hot_names[n_hot++] = name;
+  fflush(stdout);
+}
+
+void
+do_ptrs_init(FILE *F)
+{
+  unsigned i, h;
+
+  fprintf(F, "\nCONST_TABLE void *decode_ptrs [256] = {\n");
+  for (i = 0; i < n_ptrs; i++)
+    fprintf(F, "  %s,\n", ptr_names[i]);
+  fprintf(F, "};\n");
+
+  fprintf(F, "\nCONST_TABLE unsigned long *decode_ptrs_attr [256] = {\n");
+  for (i = 0; i < n_ptrs; i++) {
+    for (h = 0; h < n_hot; h++)
+      if (strcmp(ptr_names[i], hot_names[h]) == 0)
+	break;
+    if (h < n_hot)
+      fprintf(F, "  %s_attr,\n", hot_names[h]);
+    else
+      fprintf(F, "  0,\n");
+  }
+  fprintf(F, "};\n");
+  fflush(stdout);
+}
+
+/* Names of the tables that entries point into, for the direct
+   decoder */
+#define T(table) { table, #table }
+
+static const struct {
+  const OpCode *table;
+  const char *name;
+} table_names[] = {
+  T(group1_Eb_Ib), T(group1_Ev_Iv), T(group1_Ev_Ib), T(group2a_Eb_Ib),
+  T(group2a_Ev_Ib), T(group2_Eb_1), T(group2_Ev_1), T(group2_Eb_CL),
+  T(group2_Ev_CL), T(group3b), T(group3v), T(ngroup4), T(ngroup5),
+  T(ngroup6), T(ngroup7), T(group8_Ev_Ib), T(ngroup9),
+  T(twoByteOpcodes), T(nopbyte0),
+  T(float_d8), T(float_d9), T(float_da), T(float_db), T(float_dc),
+  T(float_dd), T(float_de), T(float_df),
+};
+
+static const char *
+table_name(const void *table)
+{
+  unsigned i;
+  for (i = 0; i < sizeof(table_names) / sizeof(table_names[0]); i++)
+    if (table_names[i].table == table)
+      return table_names[i].name;
+  assert(0 && "entry points to an unnamed table");
+  return 0;
+}
+
+#define IMM_ATTRS (DF_Iw|DF_Ib|DF_Jb|DF_Iv|DF_Ov|DF_Ob|DF_Jv|DF_Ap)
+
+/* Immediates of an opcode whose attributes are known here, in the
+   order of decode_immediates() */
+static void
+direct_immediates(FILE *F, unsigned attr, const char *ind)
+{
+  if (attr & DF_Iw)
+    fprintf(F, "%sdecode_Iw(M, ds);\n", ind);
+  if (attr & (DF_Ib|DF_Jb))
+    fprintf(F, "%sdecode_Ib(M, ds);\n", ind);
+  if (attr & DF_Iv)
+    fprintf(F, "%sdecode_Iv(M, ds);\n", ind);
+  if (attr & (DF_Ov|DF_Ob))
+    fprintf(F, "%sdecode_Ov(M, ds);\n", ind);
+  if (attr & (DF_Jv|DF_Ap))
+    fprintf(F, "%sdecode_Jv(M, ds);\n", ind);
+  if (attr & DF_Ap)
+    fprintf(F, "%sdecode_Ap(M, ds);\n", ind);
+}
+
+/* One switch of the direct decoder, over the byte just read into
+   ds->b. /ind/ is the indentation of the switch statement */
+static void
+direct_switch(FILE *F, const OpCode *table, const char *name, 
+	      unsigned depth, const char *ind)
+{
+  unsigned i, g;
+  char in[32];
+
+  snprintf(in, sizeof(in), "%s    ", ind);
+  fprintf(F, "%sswitch (ds->b) {\n", ind);
+
+  for (i = 0; i < 256; i++) {
+    const OpCode *op = &table[i];
+    unsigned attr = op_attr(op);
+
+    fprintf(F, "%s  case 0x%02xu:\t/* %s */\n", ind, i, op->disasm);
+
+    if (attr & DF_PREFIX) {
+      assert(depth == 0 && "prefix within an opcode");
+      fprintf(F, "%sdecode_prefix(ds);\n", in);
+      fprintf(F, "%sgoto next_byte;\n", in);
+      continue;
+    }
+
+    if (attr & DF_TABLE) {
+      assert(depth == 0 && "more than one level of opcode tables");
+      fprintf(F, "%sREAD_IN_NEXT_BYTE();\n", in);
+      direct_switch(F, (const OpCode *)op->ptr, table_name(op->ptr), 
+		    depth + 1, in);
+      fprintf(F, "%sbreak;\n", in);
+      continue;
+    }
+
+    if (attr & DF_FLOAT) {
+      /* Escape opcodes: the modR/M byte picks the entry */
+      const char *fname = table_name(op->ptr);
+      assert(depth == 0 && "escape opcode within an opcode");
+      fprintf(F, "%sREAD_IN_NEXT_BYTE();\n", in);
+      fprintf(F, "%sds->modrm.byte = ds->b;\n", in);
+      fprintf(F, "%sif (ds->modrm.parts.mod == 0x3u) {\n", in);
+      fprintf(F, "%s  pEntry = &%s[ds->modrm.parts.reg + 8];\n", in, fname);
+      fprintf(F, "%s  ds->attr = pEntry->attr;\n", in);
+      fprintf(F, "%s  if (ds->attr & DF_ONE_MORE_LEVEL) {\n", in);
+      fprintf(F, "%s    pEntry = &((CONST_TABLE OpCode *)pEntry->ptr)"
+	      "[ds->modrm.parts.rm];\n", in);
+      fprintf(F, "%s    ds->attr = pEntry->attr;\n", in);
+      fprintf(F, "%s  }\n", in);
+      fprintf(F, "%s}\n", in);
+      fprintf(F, "%selse {\n", in);
+      fprintf(F, "%s  pEntry = &%s[ds->modrm.parts.reg];\n", in, fname);
+      fprintf(F, "%s  ds->attr = pEntry->attr;\n", in);
+      fprintf(F, "%s}\n", in);
+      fprintf(F, "%semitfn = pEntry->ptr;\n", in);
+      fprintf(F, "%sif (ds->attr & (DF_MODRM|DF_GROUP))\n", in);
+      fprintf(F, "%s  decode_modrm_operand(M, ds);\n", in);
+      fprintf(F, "%sdecode_immediates(M, ds);\n", in);
+      fprintf(F, "%sbreak;\n", in);
+      continue;
+    }
+
+    fprintf(F, "%sds->attr = 0x%xu;\n", in, attr);
+
+    if (attr & DF_GROUP) {
+      /* The reg field of modR/M picks the entry. If the members do
+	 not agree on their immediates, look at them at run time */
+      const OpCode *group = (const OpCode *)op->ptr;
+      const char *gname = table_name(group);
+      unsigned imm = (attr | op_attr(&group[0])) & IMM_ATTRS;
+
+      fprintf(F, "%sREAD_IN_NEXT_BYTE();\n", in);
+      fprintf(F, "%sds->modrm.byte = ds->b;\n", in);
+      fprintf(F, "%spEntry = &%s[ds->modrm.parts.reg];\n", in, gname);
+      fprintf(F, "%sds->attr |= %s_attr[ds->modrm.parts.reg];\n", in, gname);
+      fprintf(F, "%semitfn = decode_ptrs[%s_ptr[ds->modrm.parts.reg]];\n", 
+	      in, gname);
+      fprintf(F, "%sdecode_modrm_operand(M, ds);\n", in);
+
+      for (g = 0; g < 8; g++)
+	if (((attr | op_attr(&group[g])) & IMM_ATTRS) != imm)
+	  break;
+      if (g == 8)
+	direct_immediates(F, imm, in);
+      else
+	fprintf(F, "%sdecode_immediates(M, ds);\n", in);
+    }
+    else {
+      fprintf(F, "%spEntry = &%s[0x%02xu];\n", in, name, i);
+      fprintf(F, "%semitfn = %s;\n", in, op->emitter_name);
+      if (attr & DF_MODRM) {
+	fprintf(F, "%sREAD_IN_NEXT_BYTE();\n", in);
+	fprintf(F, "%sds->modrm.byte = ds->b;\n", in);
+	fprintf(F, "%sdecode_modrm_operand(M, ds);\n", in);
+      }
+      direct_immediates(F, attr, in);
+    }
+    fprintf(F, "%sbreak;\n", in);
+  }
+  fprintf(F, "%s}\n", ind);
+}
+
+/* Decoder with one case per opcode, in which the operand decoding of
+   that opcode is spelled out, so that no table is walked and no
+   attribute is tested at run time for the common opcodes. It decodes
+   exactly as do_decode() does, and is written out by the generator
+   together with the tables, so that the two cannot go out of step */
+void
+do_direct_init(FILE *F)
+{
+  fprintf(F, "\n#include \"decode-inline.c\"\n\n");
+  fprintf(F, "bool\ndo_decode_direct(machine_t *M, decode_t *ds)\n{\n");
+  fprintf(F, "#ifdef SUPERVISOR_MODE\n");
+  fprintf(F, "  /* No instruction fetch fault checks here */\n");
+  fprintf(F, "  return do_decode(M, ds);\n");
+  fprintf(F, "#else\n");
+  fprintf(F, "  CONST_TABLE OpCode *pEntry;\n");
+  fprintf(F, "  CONST_TABLE void *emitfn;\n\n");
+  fprintf(F, "  decode_start(M, ds);\n\n");
+  fprintf(F, " next_byte:\n");
+  fprintf(F, "  decode_mark_instr(M, ds);\n");
+  fprintf(F, "  READ_IN_NEXT_BYTE();\n");
+  direct_switch(F, nopbyte0, "nopbyte0", 0, "  ");
+  fprintf(F, "\n  return decode_finish(M, ds, pEntry, emitfn);\n");
+  fprintf(F, "#endif\n}\n");
+  fflush(stdout);
+}
+
+/* The generator itself runs on the source tables, and has no direct
+   decoder of its own */
+bool
+do_decode_direct(machine_t *M, decode_t *ds)
+{
+  return do_decode(M, ds);
+}
+
 int
 main()
 {
@@ -164,6 +505,31 @@ main()
   Do_decode_init(ngroup9, 8);
   Do_decode_init(twoByteOpcodes, 256);
   Do_decode_init(nopbyte0, 256);
+
+  Do_fast_init(twoByteOpcodes, 256);
+  Do_fast_init(nopbyte0, 256);
+
+  Do_hot_init(group1_Eb_Ib, 8);
+  Do_hot_init(group1_Ev_Iv, 8);
+  Do_hot_init(group1_Ev_Ib, 8);
+  Do_hot_init(group2a_Eb_Ib, 8);
+  Do_hot_init(group2a_Ev_Ib, 8);
+  Do_hot_init(group2_Eb_1, 8);
+  Do_hot_init(group2_Ev_1, 8);
+  Do_hot_init(group2_Eb_CL, 8);
+  Do_hot_init(group2_Ev_CL, 8);
+  Do_hot_init(group3b, 8);
+  Do_hot_init(group3v, 8);
+  Do_hot_init(ngroup4, 8);
+  Do_hot_init(ngroup5, 8);
+  Do_hot_init(ngroup6, 8);
+  Do_hot_init(ngroup7, 8);
+  Do_hot_init(group8_Ev_Ib, 8);
+  Do_hot_init(ngroup9, 8);
+  Do_hot_init(twoByteOpcodes, 256);
+  Do_hot_init(nopbyte0, 256);
+  do_ptrs_init(F);
+
   Do_decode_init(float_d8, 16);
   Do_decode_init(float_d9, 16);
   Do_decode_init(float_d9_2, 8);
@@ -182,5 +548,7 @@ main()
   Do_decode_init(float_df, 16);
   Do_decode_init(float_df_4, 8);
 
+  do_direct_init(F);
+
   fclose(F);
 }
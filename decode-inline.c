@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2005, Johns Hopkins University and The EROS Group, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ *  * Neither the name of the Johns Hopkins University, nor the name
+ *    of The EROS Group, LLC, nor the names of their contributors may
+ *    be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Steps of instruction decoding that are shared by the table walker
+   in decode.c (do_decode) and by the direct-dispatch decoder that the
+   generator writes out along with the tables (do_decode_direct). Both
+   include this file, so that the two stay in step. */
+
+#define READ_IN_NEXT_BYTE() 		\
+      do {ds->b = istream_peekByte(M);	\
+      istream_nextByte(M); } while(0)				
+
+#define READ_IN_NEXT_WORD() 		\
+      do { ds->b = istream_peekWord(M);	\
+      istream_nextWord(M); } while(0)
+
+#define READ_IN_NEXT_LONG() 		\
+      do { ds->b = istream_peekLong(M);	\
+      istream_nextLong(M); } while(0)
+
+/* The operand helpers are called from every opcode case of the direct
+   decoder, more times than gcc will inline on its own */
+#define DECODE_INLINE static inline __attribute__((always_inline))
+
+static inline void
+decode_start(machine_t *M, decode_t *ds)
+{
+  ds->decode_eip = M->next_eip;
+#ifdef STATIC_PASS
+  ds->mem_decode_eip = M->mem_next_eip;
+#endif
+  ds->attr = 0;
+  ds->emitfn = 0;
+  ds->modrm_regs = 0;	   /* registers sourced by this instruction */
+  ds->need_sib = 0;
+  ds->dispBytes = 0;
+  ds->no_of_prefixes = 0;
+  ds->Group1_Prefix=0;
+  ds->Group2_Prefix=0;
+  ds->Group3_Prefix=0;
+  ds->Group4_Prefix=0;
+  ds->flags = 0;
+  ds->opstate = OPSTATE_DATA32 | OPSTATE_ADDR32;
+}
+
+/* Record the prefix byte in ds->b. Note that the prefix bytes are not
+   copied onto the instruction stream; Instead, they are just copied
+   onto their respective placeholders within the decode structure */
+static inline void
+decode_prefix(decode_t *ds)
+{
+  ds->no_of_prefixes ++;
+
+  switch(ds->b) {
+  case PREFIX_LOCK:
+  case PREFIX_REPZ:
+  case PREFIX_REPNZ:
+    ds->flags |= DSFL_GROUP1_PREFIX;
+    ds->Group1_Prefix = ds->b;
+    break;
+
+  case PREFIX_CS:
+  case PREFIX_DS:
+  case PREFIX_ES:
+  case PREFIX_FS:
+  case PREFIX_GS:
+  case PREFIX_SS:
+    ds->flags |= DSFL_GROUP2_PREFIX;
+    ds->Group2_Prefix = ds->b;
+    break;
+
+  case PREFIX_OPSZ:
+    ds->flags |= DSFL_GROUP3_PREFIX;
+    ds->opstate ^= OPSTATE_DATA32;
+    ds->Group3_Prefix = ds->b;
+    break;
+
+  case PREFIX_ADDRSZ:
+    ds->flags |= DSFL_GROUP4_PREFIX;
+    ds->opstate ^= OPSTATE_ADDR32;
+    ds->Group4_Prefix = ds->b;
+    break;
+  }
+}
+
+/* The first byte of the instruction proper, past the prefixes */
+static inline void
+decode_mark_instr(machine_t *M, decode_t *ds)
+{
+#ifdef STATIC_PASS
+  ds->instr = (unsigned char *)M->mem_next_eip;
+#else
+  ds->instr = (unsigned char *)M->next_eip;
+#endif
+}
+
+/* SIB byte and displacement, for an opcode that has a modR/M byte
+   (already read into ds->modrm) */
+DECODE_INLINE void
+decode_modrm_operand(machine_t *M, decode_t *ds)
+{
+  if (ds->opstate & OPSTATE_ADDR32) {
+    /* ds->mod of 00b, 01b, 10b  are the register-indirect cases,
+       except that ds->rm == 100b implies a sib byte and (ds->mod,
+       ds->rm) of (00b, 101b) is disp32. */
+    if ((ds->modrm.parts.mod != 0x3u) && (ds->modrm.parts.rm == 4u))
+      ds->need_sib = 1;	/* scaled index mode */
+      
+    if (ds->modrm.parts.mod == 0u && ds->modrm.parts.rm == 5u)
+      ds->dispBytes = 4;	/* memory absolute */
+    else if (ds->modrm.parts.mod == 1u)
+      ds->dispBytes = 1;
+    else if (ds->modrm.parts.mod == 2u)
+      ds->dispBytes = 4;
+  }
+  else {  
+    /* No SIB byte to consider, but pick off 
+       (ds->mod, ds->rm) == (00b,110b) since that is disp16 */
+    if (ds->modrm.parts.mod == 0u && ds->modrm.parts.rm == 6u)
+      ds->dispBytes = 2;	/* memory absolute */
+    else if (ds->modrm.parts.mod == 1u)
+      ds->dispBytes = 1;
+    else if (ds->modrm.parts.mod == 2u)
+      ds->dispBytes = 2;
+  }
+
+  if (ds->need_sib) {
+    READ_IN_NEXT_BYTE();
+    ds->sib.byte = ds->b;
+    if ((ds->sib.parts.base == GP_REG_EBP) && (ds->modrm.parts.mod == 0u))
+      ds->dispBytes = 4;
+  }
+
+  if (ds->dispBytes) {
+    if(ds->dispBytes > 2){
+      READ_IN_NEXT_LONG();
+      ds->displacement = ds->b;
+    }else if(ds->dispBytes > 1){
+      READ_IN_NEXT_WORD();
+      ds->displacement = ds->b;
+    } else{
+      READ_IN_NEXT_BYTE();
+      ds->displacement = ds->b;
+    }
+  }
+}
+
+/* The immediates (or offsets, depending on the instruction). Of the
+   instructions that take such, only one (ENTER) takes more than
+   one. Iw mode is in fact used only by ENTER, RET, and LRET. We
+   therefore proceed by handling Iw as a special case. Whichever of
+   these an opcode has, they are read in the order below. */
+
+DECODE_INLINE void
+decode_Iw(machine_t *M, decode_t *ds)
+{
+  READ_IN_NEXT_WORD();
+  ds->imm16 = ds->b;
+}
+
+/* Also Jb */
+DECODE_INLINE void
+decode_Ib(machine_t *M, decode_t *ds)
+{
+  READ_IN_NEXT_BYTE();
+  signed char sc = ds->b;	/* for sign extension */
+  ds->immediate = sc;
+}
+
+DECODE_INLINE void
+decode_Iv(machine_t *M, decode_t *ds)
+{
+  if (ds->opstate & OPSTATE_DATA32) {
+    READ_IN_NEXT_LONG();
+    ds->immediate = ds->b;
+  }
+  else{
+    READ_IN_NEXT_WORD();
+    ds->immediate = ds->b;
+  }
+}
+
+/* Ov and Ob */
+DECODE_INLINE void
+decode_Ov(machine_t *M, decode_t *ds)
+{
+  if (ds->opstate & OPSTATE_ADDR32) {
+    READ_IN_NEXT_LONG();
+    ds->immediate = ds->b;
+  }
+  else{
+    READ_IN_NEXT_WORD();
+    ds->immediate = ds->b;
+  }
+}
+
+/* Jv, and the offset part of Ap */
+DECODE_INLINE void
+decode_Jv(machine_t *M, decode_t *ds)
+{
+  if (ds->opstate & OPSTATE_DATA32) {
+    READ_IN_NEXT_LONG();
+    ds->immediate = ds->b;
+  }
+  else{
+    READ_IN_NEXT_WORD();
+    ds->immediate = ds->b;
+  }
+}
+
+/* The segment part of Ap */
+DECODE_INLINE void
+decode_Ap(machine_t *M, decode_t *ds)
+{
+  READ_IN_NEXT_WORD();
+  ds->imm16 = ds->b;
+}
+
+DECODE_INLINE void
+decode_immediates(machine_t *M, decode_t *ds)
+{
+  if (ds->attr & DF_Iw)
+    decode_Iw(M, ds);
+  if (ds->attr & (DF_Ib|DF_Jb))
+    decode_Ib(M, ds);
+  if (ds->attr & DF_Iv)
+    decode_Iv(M, ds);
+  if (ds->attr & (DF_Ov|DF_Ob))
+    decode_Ov(M, ds);
+  if (ds->attr & (DF_Jv|DF_Ap))
+    decode_Jv(M, ds);
+  if (ds->attr & DF_Ap)
+    decode_Ap(M, ds);
+}
+
+/* /pEntry/ is the last located entry, which specifies what we are
+   going to do in the end, and /emitfn/ its emitter */
+static inline bool
+decode_finish(machine_t *M, decode_t *ds, CONST_TABLE OpCode *pEntry,
+	      CONST_TABLE void *emitfn)
+{
+#ifdef STATIC_PASS
+  ds->pInstr = (unsigned char *)M->mem_next_eip;
+#else
+  ds->pInstr = (unsigned char *)M->next_eip;
+#endif
+
+  ds->emitfn = emitfn;
+  ds->pEntry = pEntry;
+  
+  if (ds->attr & DF_UNDEFINED)    {
+    DEBUG(decode)
+      printf ("\nUndefined opcode: %2X %2X at %08X\n", ds->instr[0], ds->instr[1], ds->decode_eip);
+    return false;
+  }
+
+  if (emitfn == 0)
+    return false;
+
+  return true;
+}
@@ -1,26 +1,323 @@
 #include <stdio.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <elf.h>
+#include <sys/time.h>
 #include "switches.h"
 #include "debug.h"
 #include "machine.h"
 #include "decode.h"
 #include "emit.h"
 #include "util.h"
+#include "xlcore.h"
+#include "perf.h"
 
 
 machine_t IA32;
 char instr_stream[] = {0xf2, 0x0f, 0x5c, 0xcd,
 		       //0xc3, 0xc3, 0xc3, 0xc3,
-		       0x66, 0x0f, 0x7e, 0xc2, 
+		       0x66, 0x0f, 0x7e, 0xc2,
 		       0x0};
 
+/* Translator benchmark: decode-tester <file> [reps]
+
+   <file> is a 32-bit x86 ELF executable or library, whose loadable
+   segments are laid out in memory as they would be at run time and
+   whose .text is used, or else raw code. Reports, best of /reps/:
+
+   - do_decode, do_decode_direct, and the fast path in front of the
+     direct decoder (as the translator uses them), sweeping .text
+   - xlate_bb into a machine of its own, from every direct call target
+     in .text (ELF only). Instruction and byte counts need
+     PROFILE_TRANSLATION, as the tester targets in the Makefile have.
+
+   Build decode-tester and decode-tester-old to compare the inline and
+   out-of-line emitter configurations. */
+
+typedef struct {
+  unsigned char *image;		/* Segments, as laid out at run time */
+  unsigned long image_len;
+  unsigned char *text;		/* .text within the image */
+  unsigned long text_len;
+  bool is_elf;
+} guest_code;
+
+static unsigned char *
+read_file(const char *name, unsigned long *len)
+{
+  FILE *f = fopen(name, "r");
+  unsigned char *buf;
+
+  if (f == NULL)
+    panic("Cannot open %s\n", name);
+  fseek(f, 0, SEEK_END);
+  *len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  buf = malloc(*len + MAX_BYTES_PER_INSTR);
+  if (fread(buf, 1, *len, f) != *len)
+    panic("Cannot read %s\n", name);
+  /* So that a sweep can run off the end without faulting */
+  memset(buf + *len, 0x90, MAX_BYTES_PER_INSTR);
+  fclose(f);
+  return buf;
+}
+
+static void
+load_guest_code(const char *name, guest_code *g)
+{
+  unsigned long len, i;
+  unsigned char *file = read_file(name, &len);
+  Elf32_Ehdr *eh = (Elf32_Ehdr *)file;
+  Elf32_Phdr *ph;
+  Elf32_Shdr *sh;
+  unsigned long lo = ~0ul, hi = 0;
+  const char *shstr;
+
+  if ((len < sizeof(Elf32_Ehdr)) || (memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0) ||
+      (eh->e_ident[EI_CLASS] != ELFCLASS32) || (eh->e_machine != EM_386)) {
+    g->image = g->text = file;
+    g->image_len = g->text_len = len;
+    g->is_elf = false;
+    return;
+  }
+
+  ph = (Elf32_Phdr *)(file + eh->e_phoff);
+  for (i = 0; i < eh->e_phnum; i++) {
+    if (ph[i].p_type != PT_LOAD)
+      continue;
+    if (ph[i].p_vaddr < lo)
+      lo = ph[i].p_vaddr;
+    if (ph[i].p_vaddr + ph[i].p_memsz > hi)
+      hi = ph[i].p_vaddr + ph[i].p_memsz;
+  }
+  if (lo >= hi)
+    panic("%s has no loadable segments\n", name);
+
+  g->image_len = hi - lo;
+  g->image = calloc(1, g->image_len + MAX_BYTES_PER_INSTR);
+  for (i = 0; i < eh->e_phnum; i++)
+    if (ph[i].p_type == PT_LOAD)
+      memcpy(g->image + (ph[i].p_vaddr - lo), file + ph[i].p_offset,
+	     ph[i].p_filesz);
+
+  sh = (Elf32_Shdr *)(file + eh->e_shoff);
+  shstr = (const char *)(file + sh[eh->e_shstrndx].sh_offset);
+  g->text = NULL;
+  g->text_len = 0;
+  for (i = 0; i < eh->e_shnum; i++)
+    if (strcmp(shstr + sh[i].sh_name, ".text") == 0) {
+      g->text = g->image + (sh[i].sh_addr - lo);
+      g->text_len = sh[i].sh_size;
+    }
+  if (g->text == NULL)
+    panic("%s has no .text\n", name);
+  g->is_elf = true;
+  free(file);
+}
+
+static double
+wall_time(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void
+report(const char *what, unsigned long long instrs, unsigned long long bytes,
+       unsigned long long cycles, double secs)
+{
+  printf("%-22s %9llu instrs %9llu bytes  %7.2f Minstr/s  %7.2f MB/s  "
+	 "%7.1f cycles/instr\n", what, instrs, bytes,
+	 instrs / secs / 1e6, bytes / secs / 1e6, (double)cycles / instrs);
+}
+
+#define DEC_TABLE  0
+#define DEC_DIRECT 1
+#define DEC_FAST   2
+
+/* Sweep .text linearly, skipping a byte where decoding fails */
+static unsigned long
+sweep(machine_t *M, guest_code *g, int how)
+{
+  decode_t ds;
+  unsigned long n = 0;
+  unsigned long end = (unsigned long)(g->text + g->text_len);
+  bool ok;
+
+  M->next_eip = (unsigned long)g->text;
+  while (M->next_eip < end) {
+    if ((how == DEC_FAST) && do_decode_fast(M, &ds))
+      ok = true;
+    else if (how == DEC_TABLE)
+      ok = do_decode(M, &ds);
+    else
+      ok = do_decode_direct(M, &ds);
+    if (!ok)
+      M->next_eip = ds.decode_eip + 1;
+    n++;
+  }
+  return n;
+}
+
+static void
+bench_decode(guest_code *g, int reps)
+{
+  static const char *names[] = { "do_decode", "do_decode_direct",
+				 "fast + direct" };
+  machine_t *M = &IA32;
+  int how, r;
+
+  for (how = DEC_TABLE; how <= DEC_FAST; how++) {
+    unsigned long long best = ~0ull;
+    double best_secs = 0;
+    unsigned long n = 0;
+
+    for (r = 0; r < reps; r++) {
+      double t0 = wall_time();
+      unsigned long long c0 = read_timer();
+      n = sweep(M, g, how);
+      unsigned long long c = read_timer() - c0;
+      if (c < best) {
+	best = c;
+	best_secs = wall_time() - t0;
+      }
+    }
+    report(names[how], n, g->text_len, best, best_secs);
+  }
+}
+
+/* Entry points of the translation benchmark: targets of the direct
+   calls found by sweeping .text, that fall within .text */
+static unsigned long
+find_call_targets(guest_code *g, unsigned long **targets)
+{
+  machine_t *M = &IA32;
+  decode_t ds;
+  unsigned long n = 0, max = 1024;
+  unsigned long start = (unsigned long)g->text;
+  unsigned long end = start + g->text_len;
+
+  *targets = malloc(max * sizeof(unsigned long));
+  M->next_eip = start;
+  while (M->next_eip < end) {
+    if (!do_decode(M, &ds)) {
+      M->next_eip = ds.decode_eip + 1;
+      continue;
+    }
+    if (((void *)ds.emitfn == (void *)emit_call_disp) &&
+	(ds.opstate & OPSTATE_DATA32)) {
+      unsigned long to = M->next_eip + ds.immediate;
+      if ((to >= start) && (to < end)) {
+	if (n == max) {
+	  max *= 2;
+	  *targets = realloc(*targets, max * sizeof(unsigned long));
+	}
+	(*targets)[n++] = to;
+      }
+    }
+  }
+  return n;
+}
+
+static void
+bench_xlate(guest_code *g, int reps)
+{
+  unsigned long *targets;
+  unsigned long n = find_call_targets(g, &targets);
+  machine_t *X = init_thread_trans((unsigned long)g->text);
+  unsigned long long best = ~0ull;
+  unsigned long long instrs = 0, bytes = 0;
+  unsigned long emitted = 0, done = 0, i;
+  double best_secs = 0;
+  int r;
+
+  for (r = 0; r < reps; r++) {
+    unsigned char *out0;
+    double t0;
+    unsigned long long c0, c;
+
+    xlate_reset(X);
+#ifdef PROFILE_TRANSLATION
+    X->ptState->trans_instrs = 0;
+    X->ptState->trans_bytes = 0;
+#endif
+    out0 = X->bbOut;
+    t0 = wall_time();
+    c0 = read_timer();
+    for (i = 0; i < n; i++) {
+      /* Stop short of the cache being wiped */
+      if (!ROOM_FOR_BB(X) || (X->no_of_bbs + PATCH_ARRAY_LEN >= MAX_BBS))
+	break;
+      X->fixregs.eip = targets[i];
+      X->comming_from_call_indirect = false;
+      xlate_bb(X);
+    }
+    c = read_timer() - c0;
+    if (c < best) {
+      best = c;
+      best_secs = wall_time() - t0;
+      done = i;
+      emitted = X->bbOut - out0;
+#ifdef PROFILE_TRANSLATION
+      instrs = X->ptState->trans_instrs;
+      bytes = X->ptState->trans_bytes;
+#endif
+    }
+  }
+
+  printf("xlate_bb: %lu of %lu call targets, %lu traces, %lu code bytes\n",
+	 done, n, X->no_of_bbs, emitted);
+#ifdef PROFILE_TRANSLATION
+  report("xlate_bb", instrs, bytes, best, best_secs);
+  printf("%-22s %7.2f code bytes per guest byte\n", "expansion",
+	 (double)emitted / bytes);
+#else
+  printf("%-22s %llu cycles, %.2f code MB/s "
+	 "(PROFILE_TRANSLATION for per-instruction figures)\n",
+	 "xlate_bb", best, emitted / best_secs / 1e6);
+#endif
+#ifdef PROFILE_XLATE_PHASES
+  printf("\nxlate_bb phases, over all %d reps:\n", reps);
+  xlate_prof_report(X, stdout);
+#endif
+  free(targets);
+}
+
+static void
+bench(const char *name, int reps)
+{
+  guest_code g;
+
+  load_guest_code(name, &g);
+  printf("%s: %lu bytes of %s, emitters %s\n", name, g.text_len,
+	 g.is_elf ? ".text" : "raw code",
+#ifdef INLINE_EMITTERS
+	 "inline"
+#else
+	 "out of line"
+#endif
+	 );
+
+  bench_decode(&g, reps);
+  if (g.is_elf)
+    bench_xlate(&g, reps);
+}
+
 int
-main()
+main(int argc, char **argv)
 {
   machine_t *M = &IA32;
   decode_t ds;
   decode_t *d = &ds;
+
+  if (argc > 1) {
+    bench(argv[1], (argc > 2) ? atoi(argv[2]) : 5);
+    return 0;
+  }
+
   M->next_eip = (unsigned long)instr_stream;
   while(*((unsigned char *) M->next_eip)) {
     do_decode(M, d);
@@ -47,17 +47,7 @@
 #include "decode.h"
 #include "emit.h"
 
-#define READ_IN_NEXT_BYTE() 		\
-      do {ds->b = istream_peekByte(M);	\
-      istream_nextByte(M); } while(0)				
-
-#define READ_IN_NEXT_WORD() 		\
-      do { ds->b = istream_peekWord(M);	\
-      istream_nextWord(M); } while(0)
-
-#define READ_IN_NEXT_LONG() 		\
-      do { ds->b = istream_peekLong(M);	\
-      istream_nextLong(M); } while(0)
+#include "decode-inline.c"
 
 static _count = 0;
 
@@ -71,22 +61,7 @@ do_decode(machine_t *M, decode_t *ds)
 
   //printf("TEST: do_decode(%x) is called %d times!\n", ds, _count++);
 
-  ds->decode_eip = M->next_eip;
-#ifdef STATIC_PASS
-  ds->mem_decode_eip = M->mem_next_eip;
-#endif
-  ds->attr = 0;
-  ds->emitfn = 0;
-  ds->modrm_regs = 0;	   /* registers sourced by this instruction */
-  ds->need_sib = 0;
-  ds->dispBytes = 0;
-  ds->no_of_prefixes = 0;
-  ds->Group1_Prefix=0;
-  ds->Group2_Prefix=0;
-  ds->Group3_Prefix=0;
-  ds->Group4_Prefix=0;
-  ds->flags = 0;
-  ds->opstate = OPSTATE_DATA32 | OPSTATE_ADDR32;
+  decode_start(M, ds);
 
   /* First, pick off the opcode prefixes. There can be more than one.
 
@@ -106,50 +81,12 @@ do_decode(machine_t *M, decode_t *ds)
     if ((ds->attr & DF_PREFIX) == 0)
       break;
     
-    ds->no_of_prefixes ++;
-
-    switch(ds->b) {
-    case PREFIX_LOCK:
-    case PREFIX_REPZ:
-    case PREFIX_REPNZ:
-      ds->flags |= DSFL_GROUP1_PREFIX;
-      ds->Group1_Prefix = ds->b;
-      break;
-
-    case PREFIX_CS:
-    case PREFIX_DS:
-    case PREFIX_ES:
-    case PREFIX_FS:
-    case PREFIX_GS:
-    case PREFIX_SS:
-      ds->flags |= DSFL_GROUP2_PREFIX;
-      ds->Group2_Prefix = ds->b;
-      break;
-
-    case PREFIX_OPSZ:
-      ds->flags |= DSFL_GROUP3_PREFIX;
-      ds->opstate ^= OPSTATE_DATA32;
-      ds->Group3_Prefix = ds->b;
-      break;
-
-    case PREFIX_ADDRSZ:
-      ds->flags |= DSFL_GROUP4_PREFIX;
-      ds->opstate ^= OPSTATE_ADDR32;
-      ds->Group4_Prefix = ds->b;
-      break;
-    }
-    
-    /* Note that the prefix bytes are not copied onto the instruction stream; Instead, they are just 
-       copied onto their respective placeholders within the decode structure */
+    decode_prefix(ds);
     istream_nextByte(M);
   }
 
   /* Pick off the instruction bytes */
-#ifdef STATIC_PASS
-  ds->instr = (unsigned char *)M->mem_next_eip;
-#else
-  ds->instr = (unsigned char *)M->next_eip;
-#endif
+  decode_mark_instr(M, ds);
 
   for(;;) {
     ds->b = istream_peekByte(M);
@@ -227,141 +164,110 @@ do_decode(machine_t *M, decode_t *ds)
    * the end. Finish copying modrm arguments and immediate values, if
    * any. 
    */
-  if (ds->attr & (DF_MODRM|DF_GROUP)) {
-    if (ds->opstate & OPSTATE_ADDR32) {
-      /* ds->mod of 00b, 01b, 10b  are the register-indirect cases,
-	 except that ds->rm == 100b implies a sib byte and (ds->mod,
-	 ds->rm) of (00b, 101b) is disp32. */
-      if ((ds->modrm.parts.mod != 0x3u) && (ds->modrm.parts.rm == 4u))
-	ds->need_sib = 1;	/* scaled index mode */
-      
-      if (ds->modrm.parts.mod == 0u && ds->modrm.parts.rm == 5u)
-	ds->dispBytes = 4;	/* memory absolute */
-      else if (ds->modrm.parts.mod == 1u)
-	ds->dispBytes = 1;
-      else if (ds->modrm.parts.mod == 2u)
-	ds->dispBytes = 4;
-    }
-    else {  
-      /* No SIB byte to consider, but pick off 
-         (ds->mod, ds->rm) == (00b,110b) since that is disp16 */
-      if (ds->modrm.parts.mod == 0u && ds->modrm.parts.rm == 6u)
-	ds->dispBytes = 2;	/* memory absolute */
-      else if (ds->modrm.parts.mod == 1u)
-	ds->dispBytes = 1;
-      else if (ds->modrm.parts.mod == 2u)
-	ds->dispBytes = 2;
-    }
+  if (ds->attr & (DF_MODRM|DF_GROUP))
+    decode_modrm_operand(M, ds);
 
-    if (ds->need_sib) {
-      READ_IN_NEXT_BYTE();
-      ds->sib.byte = ds->b;
-      if ((ds->sib.parts.base == GP_REG_EBP) && (ds->modrm.parts.mod == 0u))
-	ds->dispBytes = 4;
-    }
+  decode_immediates(M, ds);
+  
+  return decode_finish(M, ds, pEntry, pEntry->ptr);
 
-    if (ds->dispBytes) {
-      if(ds->dispBytes > 2){
-	READ_IN_NEXT_LONG();
-	ds->displacement = ds->b;
-      }else if(ds->dispBytes > 1){
-	READ_IN_NEXT_WORD();
-	ds->displacement = ds->b;
-      } else{
-	READ_IN_NEXT_BYTE();
-	ds->displacement = ds->b;
-      }
-		
-    }
-  }
+ handle_ifault:
+  /* We took an instruction fetch fault of some form on this byte. */
+#ifdef STATIC_PASS
+      ds->pInstr = (unsigned char *)M->mem_next_eip;
+#else
+  ds->pInstr = (unsigned char *)M->next_eip;
+#endif
 
-  /* At this point we have everything except the immediates (or
-     offsets, depending on the instruction. Of the instructions that
-     take such, only one (ENTER) takes more than one. Iw mode is in
-     fact used only by ENTER, RET, and LRET. We therefore proceed by
-     handling Iw as a special case. */
+  ds->emitfn = pEntry->ptr;
+  ds->pEntry = pEntry;
 
-  if (ds->attr & DF_Iw) {
-    READ_IN_NEXT_WORD();
-    ds->imm16 = ds->b;
-  }
+  return false;
+}
 
-  if ((ds->attr & DF_Ib) || (ds->attr & DF_Jb)) {
-    READ_IN_NEXT_BYTE();
-    signed char sc = ds->b;	/* for sign extension */
-    ds->immediate = sc;
-  }
+/* Length-only decode of the common case: an instruction without
+   prefixes that is emitted by emit_normal. Only the fields that the
+   translation loop and emit_normal look at are filled in (decode_eip,
+   mem_decode_eip, instr, pInstr, attr, opstate, emitfn and pEntry),
+   and M->next_eip is left past the instruction. Returns false, having
+   consumed nothing, if do_decode has to be used instead. */
+bool
+do_decode_fast(machine_t *M, decode_t *ds)
+{
+#ifdef SUPERVISOR_MODE
+  /* No instruction fetch fault checks here */
+  return false;
+#else
+  unsigned char *p;
+  CONST_TABLE OpCode *pEntry;
+  unsigned fast, len, next;
+  modrm_union modrm;
+  unsigned attr;
 
-  if (ds->attr & DF_Iv) {
-    if (ds->opstate & OPSTATE_DATA32) {
-      READ_IN_NEXT_LONG();
-      ds->immediate = ds->b;
-    }
-    else{
-      READ_IN_NEXT_WORD();
-      ds->immediate = ds->b;
-    }
+#ifdef STATIC_PASS
+  p = (unsigned char *)M->mem_next_eip;
+#else
+  p = (unsigned char *)M->next_eip;
+#endif
+
+  if (p[0] == 0x0Fu) {
+    fast = twoByteOpcodes_fast[p[1]];
+    if (fast == 0)
+      return false;
+    pEntry = &twoByteOpcodes[p[1]];
+    attr = twoByteOpcodes_attr[p[1]];
+    next = twoByteOpcodes_ptr[p[1]];
+    len = 2;
+  }
+  else {
+    fast = nopbyte0_fast[p[0]];
+    if (fast == 0)
+      return false;
+    pEntry = &nopbyte0[p[0]];
+    attr = nopbyte0_attr[p[0]];
+    next = nopbyte0_ptr[p[0]];
+    len = 1;
   }
 
-  if ((ds->attr & DF_Ov) || (ds->attr & DF_Ob)) {
+  if (fast & FAST_MODRM) {
+    modrm.byte = p[len++];
+    if (modrm.parts.mod != 0x3u) {
+      if (modrm.parts.rm == 4u) {
+	/* SIB byte, with a disp32 in place of an EBP base */
+	if ((modrm.parts.mod == 0u) && ((p[len] & 0x7u) == GP_REG_EBP))
+	  len += 4;
+	len++;
+      }
+      else if ((modrm.parts.mod == 0u) && (modrm.parts.rm == 5u))
+	len += 4;
 
-    if (ds->opstate & OPSTATE_ADDR32) {
-      READ_IN_NEXT_LONG();
-      ds->immediate = ds->b;
-    }
-    else{
-      READ_IN_NEXT_WORD();
-      ds->immediate = ds->b;
+      if (modrm.parts.mod == 1u)
+	len += 1;
+      else if (modrm.parts.mod == 2u)
+	len += 4;
     }
-  }
 
-  if (ds->attr & (DF_Jv|DF_Ap)) {
-	
-    if (ds->opstate & OPSTATE_DATA32) {
-      READ_IN_NEXT_LONG();
-      ds->immediate = ds->b;
-    }
-    else{
-      READ_IN_NEXT_WORD();
-      ds->immediate = ds->b;
+    if (fast & FAST_GROUP) {
+      pEntry = ((CONST_TABLE OpCode *)decode_ptrs[next]) + modrm.parts.reg;
+      attr |= decode_ptrs_attr[next][modrm.parts.reg];
     }
   }
+  len += FAST_IMM_BYTES(fast);
 
-  if (ds->attr & DF_Ap) {
-    READ_IN_NEXT_WORD();
-    ds->imm16 = ds->b;
-  }
-  
+  ds->decode_eip = M->next_eip;
 #ifdef STATIC_PASS
-      ds->pInstr = (unsigned char *)M->mem_next_eip;
-#else
-  ds->pInstr = (unsigned char *)M->next_eip;
+  ds->mem_decode_eip = M->mem_next_eip;
+  M->mem_next_eip += len;
 #endif
+  M->next_eip += len;
 
-  ds->emitfn = pEntry->ptr;
+  ds->instr = p;
+  ds->pInstr = p + len;
+  ds->attr = attr;
+  ds->opstate = OPSTATE_DATA32 | OPSTATE_ADDR32;
+  ds->emitfn = emit_normal;
   ds->pEntry = pEntry;
-  
-  if (ds->attr & DF_UNDEFINED)    {
-    DEBUG(decode)
-      printf ("\nUndefined opcode: %2X %2X at %08X\n", ds->instr[0], ds->instr[1], ds->decode_eip);
-    return false;
-  }
-
-  if (pEntry->ptr == 0)
-    return false;
 
   return true;
-
- handle_ifault:
-  /* We took an instruction fetch fault of some form on this byte. */
-#ifdef STATIC_PASS
-      ds->pInstr = (unsigned char *)M->mem_next_eip;
-#else
-  ds->pInstr = (unsigned char *)M->next_eip;
-#endif
-
-  ds->emitfn = pEntry->ptr;
-  ds->pEntry = pEntry;
-
-  return false;
+#endif /* SUPERVISOR_MODE */
 }
@@ -106,61 +106,9 @@ typedef struct {
 #define OPSTATE_ADDR16 0x0u
 #define OPSTATE_DATA16 0x0u
 
-typedef struct decode_s decode_t;
-struct decode_s {
-  unsigned long decode_eip; /* Start of the Guest Instruction */
-
-/*
-#ifdef STATIC_PASS
-This section has temporarily not been ifdefed 
-ON PURPOSE.
-The Dynamic loader has to map the same structure 
-as dumped by the static pass.
-*/
-  unsigned long mem_decode_eip; /* Start of the in-memort COPY 
-				   of the Guest Instruction */
-/*
-#endif
-*/
-  unsigned char *instr;	 /* Pointer to the instruction AFTER ALL the 
-			    Prefix Bytes */
-  unsigned char *pInstr; /* End of Instruction pointer. 
-			    Actually holds the start of next Instruction */			    
-  unsigned attr;
-
-  unsigned char Group1_Prefix;
-  unsigned char Group2_Prefix;
-  unsigned char Group3_Prefix;
-  unsigned char Group4_Prefix;
-  unsigned char no_of_prefixes;
-  unsigned flags;
-
-  const bool (*emitfn)(machine_t *M, decode_t *ds);
-  const void *pEntry;		/* for disassembly */
-
-  unsigned long b;
-  unsigned opstate;
-
-  /* Saved pieces of the opcode, where applicable: */
-  /* The modrm byte: */
-  modrm_union modrm;
-
-  /* Decode of the SIB byte: */
-  unsigned char need_sib;
-  sib_union sib;
-
-  unsigned dispBytes;		/* displacement length */
-  long displacement;		/* SIGNED displacement */
-
-  /* Registers implicated by the modrm and sib bytes */
-  unsigned long modrm_regs;
-
-  long immediate;		/* SIGNED immediate */
-  long imm16;			/* used in ENTER, RET */
-
-};
-
 extern bool do_decode(machine_t *M, decode_t *ds);
+extern bool do_decode_fast(machine_t *M, decode_t *ds);
+extern bool do_decode_direct(machine_t *M, decode_t *ds);
 
 #ifdef MODETYPE
 #define MODE(x) ((MODETYPE) (x))
@@ -295,4 +243,32 @@ CONST_TABLE OpCode float_de_3[8];
 CONST_TABLE OpCode float_df[16];
 CONST_TABLE OpCode float_df_4[8];
 
+/* Length-only decode, generated alongside the tables above: for every
+   opcode byte (and for every byte following 0x0F), either 0, meaning
+   go through do_decode(), or the layout of an instruction without
+   prefixes that is emitted by emit_normal */
+#define FAST_NORMAL   0x1u
+#define FAST_MODRM    0x2u	/* Has a modR/M byte, with SIB and displacement */
+#define FAST_GROUP    0x4u	/* Opcode is picked by the reg field of modR/M */
+#define FAST_IMM(n)   ((n) << 4)	/* Bytes of immediates / offsets */
+#define FAST_IMM_BYTES(f) (((f) >> 4) & 0xfu)
+
+CONST_TABLE unsigned char nopbyte0_fast[256];
+CONST_TABLE unsigned char twoByteOpcodes_fast[256];
+
+/* Hot decode data, also generated alongside the tables: the attributes
+   of the entries of a table, and the index in decode_ptrs[] of what
+   they point to. The OpCode tables hold the rest (disassembly, operand
+   modes, flag effects), and are not read when decoding the common
+   instructions */
+CONST_TABLE unsigned long nopbyte0_attr[256];
+CONST_TABLE unsigned char nopbyte0_ptr[256];
+CONST_TABLE unsigned long twoByteOpcodes_attr[256];
+CONST_TABLE unsigned char twoByteOpcodes_ptr[256];
+
+/* Emitters and tables pointed to, and the attributes of the entries
+   of such a table */
+CONST_TABLE void *decode_ptrs[256];
+CONST_TABLE unsigned long *decode_ptrs_attr[256];
+
 #endif /* DECODE_H */
@@ -43,8 +43,13 @@
 #include <string.h>
 #include <stdlib.h>
 #include <bfd.h>
+#include <elf.h>
 #include <stdarg.h>
 #include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <sys/wait.h>
 //#include <libsherpa/UExcept.hxx>
 //#include <libsherpa/avl.hxx>
 
@@ -57,6 +62,13 @@ extern "C" {
   bb_entry * xlate_bb(machine_t *M);
   bb_entry * lookup_bb_eip(machine_t *M, unsigned long src_eip);
   void simple_patch(machine_t *M, unsigned long at, unsigned long addr);
+  void sgen_patch_block(machine_t *M, unsigned long at, unsigned long to,
+			unsigned long proc);
+  bool keep_patch_blocks(machine_t *M, const unsigned char *limit, 
+			 unsigned long n);
+  bool room_for_bb(machine_t *M);
+  void merge_bb_entry(machine_t *M, unsigned long src, unsigned long trans,
+		      unsigned long proc);
   void dump_to_file(machine_t *M, char *str);
   void int_stub(machine_t *M);
 };
@@ -73,22 +85,50 @@ show_sections(bfd *abfd, asection *sec, void *nul)
 	 sec->vma, (sec->flags & SEC_CODE) ? "IS CODE" : "IS NOT CODE");
 }
 
+/* The code the translator reads: each executable PT_LOAD of /name/,
+   straight from a read-only mapping of the file, in address order */
 sec_mem *
-get_into_mem(bfd *abfd)
+map_code_segments(const char *name, unsigned long *nsegs)
 {
-  unsigned long sec_size;
-  asection *sec;
-  unsigned int i;
-  sec_mem *sec_info = (sec_mem *) malloc(abfd->section_count * sizeof(sec_mem));
-  for(sec = abfd->sections, i=0; sec != NULL ; sec = sec->next, i++) {
-    sec_info[i].id = sec->id;
-    sec_info[i].name = sec->name;
-    sec_info[i].start = sec->vma;
-    sec_size = bfd_section_size(abfd, sec); /* Assuming 1 octet per byte */
-    sec_info[i].end =  sec->vma + sec_size;
-    sec_info[i].inmem = (unsigned char *)malloc(sec_size);
-    bfd_get_section_contents(abfd, sec, sec_info[i].inmem, 0, sec_size);
+  struct stat st;
+  unsigned char *file;
+  Elf32_Ehdr *eh;
+  Elf32_Phdr *ph;
+  sec_mem *sec_info;
+  unsigned int i, n = 0;
+  int fd = open(name, O_RDONLY);
+
+  if((fd == -1) || (fstat(fd, &st) == -1))
+    panic("Could not open %s\n", name);
+  file = (unsigned char *)mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if(file == MAP_FAILED)
+    panic("Could not map %s: %s\n", name, strerror(errno));
+  close(fd);
+
+  eh = (Elf32_Ehdr *)file;
+  if((st.st_size < (off_t)sizeof(Elf32_Ehdr)) || 
+     (memcmp(eh->e_ident, ELFMAG, SELFMAG) != 0) ||
+     (eh->e_ident[EI_CLASS] != ELFCLASS32) || (eh->e_machine != EM_386) ||
+     (eh->e_phoff + eh->e_phnum * sizeof(Elf32_Phdr) > (unsigned long)st.st_size))
+    panic("%s is not a 32-bit x86 ELF file\n", name);
+
+  ph = (Elf32_Phdr *)(file + eh->e_phoff);
+  sec_info = (sec_mem *) malloc(eh->e_phnum * sizeof(sec_mem));
+  for(i = 0; i < eh->e_phnum; i++) {
+    if((ph[i].p_type != PT_LOAD) || !(ph[i].p_flags & PF_X) ||
+       (ph[i].p_offset + ph[i].p_filesz > (unsigned long)st.st_size))
+      continue;
+    sec_info[n].id = i;
+    sec_info[n].name = "code segment";
+    sec_info[n].start = ph[i].p_vaddr;
+    sec_info[n].end = ph[i].p_vaddr + ph[i].p_filesz;
+    sec_info[n].inmem = file + ph[i].p_offset;
+    n++;
   }
+  if(n == 0)
+    panic("%s has no code segments\n", name);
+
+  *nsegs = n;
   return sec_info;
 }
 
@@ -98,6 +138,462 @@ struct patch_st {
   unsigned long proc_addr;
 };
 
+/* Entry points that the binary itself gives away, so that a plain
+   "sgen <binary>" finds most of its code. Code reached from these by
+   direct jumps and calls is found as the worklist is translated, since
+   their targets come back as patch points */
+
+static bool
+in_code(bfd *abfd, ulong addr)
+{
+  asection *sec;
+  for(sec = abfd->sections; sec != NULL; sec = sec->next)
+    if((sec->flags & SEC_CODE) && (addr >= sec->vma) && 
+       (addr < sec->vma + bfd_section_size(abfd, sec)))
+      return true;
+  return false;
+}
+
+/* Defined functions among /syms/ */
+static ulong
+symbol_entries(bfd *abfd, asymbol **syms, long nsyms, AvlTree<ulong> &worklist)
+{
+  ulong n = 0;
+  long i;
+
+  for(i = 0; i < nsyms; i++) {
+    asymbol *sym = syms[i];
+    if(!(sym->flags & BSF_FUNCTION) || bfd_is_und_section(sym->section) ||
+       !in_code(abfd, bfd_asymbol_value(sym)))
+      continue;
+    worklist.insert(bfd_asymbol_value(sym));
+    n++;
+  }
+  return n;
+}
+
+/* The function pointers in the initializer / finalizer arrays. On
+   i386 the relocations of a PIE leave these in place, as addends */
+static ulong
+array_entries(bfd *abfd, AvlTree<ulong> &worklist)
+{
+  static const char *names[] = { ".preinit_array", ".init_array", 
+				 ".fini_array", ".ctors", ".dtors" };
+  ulong n = 0, i, j;
+
+  for(i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    asection *sec = bfd_get_section_by_name(abfd, names[i]);
+    if(sec == NULL)
+      continue;
+    ulong size = bfd_section_size(abfd, sec);
+    bfd_byte *buf = (bfd_byte *)malloc(size);
+    if(bfd_get_section_contents(abfd, sec, buf, 0, size))
+      for(j = 0; j + 4 <= size; j += 4) {
+	ulong addr = bfd_get_32(abfd, buf + j);
+	if(in_code(abfd, addr)) {
+	  worklist.insert(addr);
+	  n++;
+	}
+      }
+    free(buf);
+  }
+  return n;
+}
+
+/* Add to /worklist/ the functions of the symbol table and of the
+   dynamic symbol table (exports), the PLT entries and whatever the
+   init / fini arrays point to */
+static void
+find_entries(bfd *abfd, AvlTree<ulong> &worklist)
+{
+  asymbol **syms = NULL, **dynsyms = NULL, *synth = NULL;
+  long nsyms = 0, ndynsyms = 0, nsynth = 0, size;
+  ulong from_syms = 0, from_dyn = 0, from_plt = 0, from_arrays;
+  long i;
+
+  size = bfd_get_symtab_upper_bound(abfd);
+  if(size > 0) {
+    syms = (asymbol **)malloc(size);
+    nsyms = bfd_canonicalize_symtab(abfd, syms);
+    if(nsyms < 0)
+      nsyms = 0;
+    from_syms = symbol_entries(abfd, syms, nsyms, worklist);
+  }
+
+  size = bfd_get_dynamic_symtab_upper_bound(abfd);
+  if(size > 0) {
+    dynsyms = (asymbol **)malloc(size);
+    ndynsyms = bfd_canonicalize_dynamic_symtab(abfd, dynsyms);
+    if(ndynsyms < 0)
+      ndynsyms = 0;
+    from_dyn = symbol_entries(abfd, dynsyms, ndynsyms, worklist);
+  }
+
+  /* foo@plt and the like */
+  nsynth = bfd_get_synthetic_symtab(abfd, nsyms, syms, ndynsyms, dynsyms, &synth);
+  for(i = 0; i < nsynth; i++) {
+    ulong addr = bfd_asymbol_value(&synth[i]);
+    if(in_code(abfd, addr)) {
+      worklist.insert(addr);
+      from_plt++;
+    }
+  }
+
+  from_arrays = array_entries(abfd, worklist);
+
+  printf("sgen: entry points: %lu from symbols, %lu exported, %lu in the PLT, "
+	 "%lu from init / fini arrays\n", from_syms, from_dyn, from_plt, from_arrays);
+
+  free(synth);
+  free(dynsyms);
+  free(syms);
+}
+
+/* bb_entries kept in reserve for the trace being translated */
+#define SGEN_BBS_PER_TRACE 256
+
+/* Add the targets of the patch points of the trace just translated to
+   the worklist, and keep the patch points for the end */
+static void
+take_patches(machine_t *M, AvlTree<ulong> &worklist, std::vector<patch_st> &patches)
+{
+  ulong i;
+
+  for(i = 0; i < M->patch_count; i++) {
+    patch_st p;
+    p.at = (unsigned long)M->patch_array[i].at;
+    p.to = (unsigned long)M->patch_array[i].to;
+    p.proc_addr = (unsigned long)M->patch_array[i].proc_addr;
+    worklist.insert(p.to);
+    patches.push_back(p);
+  }
+  M->patch_count = 0;
+}
+
+/* Patch points whose target may not be translated by the end of the
+   pass, and so need a patch block then: at most /count/ of the first
+   /upto/ patches, and any taken since */
+struct sgen_pending {
+  ulong count;
+  ulong upto;
+};
+
+static ulong
+pending_bound(sgen_pending &pend, std::vector<patch_st> &patches)
+{
+  return pend.count + (patches.size() - pend.upto);
+}
+
+static bool
+resolved(machine_t *M, patch_st &p)
+{
+  bb_entry *entry = lookup_bb_eip(M, p.to);
+  return (entry != NULL) && (entry->trans_bb_eip != NOT_YET_TRANSLATED);
+}
+
+/* Can one more trace be translated, still keeping room at the end of
+   the cache, below /limit/, for a patch block (and a bb_entry) for each
+   patch point that may be left over? Lowers M->bbLimit to keep it. The
+   bound on those patch points is counted exactly only once it is in
+   the way */
+static bool
+sgen_room(machine_t *M, const unsigned char *limit, sgen_pending &pend,
+	  std::vector<patch_st> &patches)
+{
+  bool exact = false;
+  ulong i, n;
+
+  for(;;) {
+    n = pending_bound(pend, patches);
+    if(keep_patch_blocks(M, limit, n) && room_for_bb(M) &&
+       (M->no_of_bbs + n + SGEN_BBS_PER_TRACE < MAX_BBS))
+      return true;
+    if(exact)
+      return false;
+
+    pend.count = 0;
+    for(i = 0; i < patches.size(); i++)
+      if(!resolved(M, patches[i]))
+	pend.count++;
+    pend.upto = patches.size();
+    exact = true;
+  }
+}
+
+/* Profile (sgen -p): a block address per line, in hex, optionally
+   followed by its execution count. Blocks are laid out hottest first,
+   and those without a count in the order listed. Only the first line
+   for a block counts. The bbstat file of OUTPUT_BB_STAT has no counts,
+   and lists traces in the order that they were first run */
+struct profile_entry {
+  unsigned long addr;
+  unsigned long count;
+  unsigned long order;
+};
+
+static bool
+hotter(const profile_entry &a, const profile_entry &b)
+{
+  if(a.count != b.count)
+    return a.count > b.count;
+  return a.order < b.order;
+}
+
+static void
+read_profile(const char *name, std::vector<profile_entry> &hot)
+{
+  char line[256];
+  profile_entry e;
+  std::set<ulong> seen;
+  FILE *F = fopen(name, "r");
+
+  if(F == NULL)
+    panic("Could not open profile %s\n", name);
+  while(fgets(line, sizeof(line), F) != NULL) {
+    e.count = 0;
+    if(sscanf(line, "%lx %lu", &e.addr, &e.count) < 1)
+      continue;
+    if(!seen.insert(e.addr).second)
+      continue;
+    e.order = hot.size();
+    hot.push_back(e);
+  }
+  fclose(F);
+  std::stable_sort(hot.begin(), hot.end(), hotter);
+}
+
+/* Parallel translation (sgen -j N). Each round takes the whole
+   worklist and deals it out to N forked workers. A worker has its own
+   copy of the machine at the same address, so code it translates needs
+   no relocation once copied back, as long as it was translated at its
+   final place in the cache. Workers therefore run twice: once to learn
+   how many bytes each one emits, and once more at the addresses that
+   the merge assigns, packed one after the other. This needs the size
+   of the code to not depend on where it is placed */
+#if !defined(PEEPHOLE_OPT) && !defined(TRACE_ALIGN) && !defined(PROFILE_BB_STATS)
+#define SGEN_PARALLEL
+#endif
+
+#ifdef SGEN_PARALLEL
+/* Rounds smaller than this many addresses per worker are done serially */
+#define SGEN_MIN_PER_JOB 16
+
+struct sgen_entry {
+  unsigned long src;
+  unsigned long trans;
+  unsigned long proc;
+};
+
+static void
+write_all(int fd, const void *buf, size_t len)
+{
+  const char *p = (const char *)buf;
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n <= 0)
+      panic("sgen worker: write failed: %s\n", strerror(errno));
+    p += n;
+    len -= n;
+  }
+}
+
+static void
+read_all(int fd, void *buf, size_t len)
+{
+  char *p = (char *)buf;
+  while (len > 0) {
+    ssize_t n = read(fd, p, len);
+    if (n <= 0)
+      panic("sgen: short read from worker\n");
+    p += n;
+    len -= n;
+  }
+}
+
+template<class T> static void
+write_vector(int fd, std::vector<T> &v)
+{
+  unsigned long n = v.size();
+  write_all(fd, &n, sizeof(n));
+  if (n)
+    write_all(fd, &v[0], n * sizeof(T));
+}
+
+template<class T> static void
+read_vector(int fd, std::vector<T> &v)
+{
+  unsigned long n;
+  read_all(fd, &n, sizeof(n));
+  v.resize(n);
+  if (n)
+    read_all(fd, &v[0], n * sizeof(T));
+}
+
+/* Worker /k/ of /n/: translate every n-th address, starting with the
+   k-th, into [base, base + share) and using at most /nbbs/ new
+   bb_entries. Writes the number of bytes emitted to /fd/ and, unless
+   /dry/, the code, the bb_entries translated into it, the patch points
+   and the addresses left over for want of room */
+static void
+sgen_worker(machine_t *M, std::vector<ulong> &addrs, unsigned k, unsigned n,
+	    unsigned char *base, ulong share, ulong nbbs, int fd, bool dry)
+{
+  std::vector<patch_st> pats;
+  std::vector<ulong> left;
+  std::vector<sgen_entry> entries;
+  ulong nbbs0 = M->no_of_bbs;
+  ulong i, j;
+
+  M->bbOut = base;
+
+  /* Keep room in the share for a patch block for each patch point */
+  for (i = k; i < addrs.size(); i += n) {
+    if (!keep_patch_blocks(M, base + share, pats.size()) || !room_for_bb(M) ||
+	(M->no_of_bbs - nbbs0 + pats.size() + SGEN_BBS_PER_TRACE > nbbs)) {
+      left.push_back(addrs[i]);
+      continue;
+    }
+    M->fixregs.eip = addrs[i];
+    xlate_bb(M);
+    for (j = 0; j < M->patch_count; j++) {
+      patch_st p;
+      p.at = (unsigned long)M->patch_array[j].at;
+      p.to = (unsigned long)M->patch_array[j].to;
+      p.proc_addr = (unsigned long)M->patch_array[j].proc_addr;
+      pats.push_back(p);
+    }
+    M->patch_count = 0;
+  }
+
+  ulong used = M->bbOut - base;
+  write_all(fd, &used, sizeof(used));
+  if (dry)
+    return;
+
+  write_all(fd, base, used);
+
+  /* New entries, and older ones that were pending until now */
+  for (j = 0; j < M->no_of_bbs; j++) {
+    bb_entry *b = &M->bb_entry_nodes[j];
+    if ((j >= nbbs0) || 
+	((b->trans_bb_eip >= (unsigned long)base) && 
+	 (b->trans_bb_eip < (unsigned long)M->bbOut))) {
+      sgen_entry e;
+      e.src = b->src_bb_eip;
+      e.trans = b->trans_bb_eip;
+      e.proc = b->proc_entry;
+      entries.push_back(e);
+    }
+  }
+  write_vector(fd, entries);
+  write_vector(fd, pats);
+  write_vector(fd, left);
+}
+
+static pid_t
+sgen_spawn(machine_t *M, std::vector<ulong> &addrs, unsigned k, unsigned n,
+	   unsigned char *base, ulong share, ulong nbbs, int *fd, bool dry)
+{
+  int p[2];
+  pid_t pid;
+
+  if (pipe(p) < 0)
+    panic("sgen: pipe failed: %s\n", strerror(errno));
+  fflush(stdout);
+  fflush(DBG);
+
+  pid = fork();
+  if (pid < 0)
+    panic("sgen: fork failed: %s\n", strerror(errno));
+  if (pid == 0) {
+    close(p[0]);
+    sgen_worker(M, addrs, k, n, base, share, nbbs, p[1], dry);
+    fflush(stdout);
+    fflush(DBG);
+    _exit(0);
+  }
+  close(p[1]);
+  *fd = p[0];
+  return pid;
+}
+
+static void
+sgen_wait(pid_t pid)
+{
+  int status;
+  if ((waitpid(pid, &status, 0) != pid) || 
+      !WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+    panic("sgen: worker %d failed\n", pid);
+}
+
+/* Translate /addrs/ with /n/ workers, and merge what they did into M.
+   /kept/ bb_entries are kept back for the patch blocks at the end */
+static void
+sgen_round(machine_t *M, std::vector<ulong> &addrs, unsigned n, ulong kept,
+	   AvlTree<ulong> &worklist, std::vector<patch_st> &patches)
+{
+  std::vector<pid_t> pids(n);
+  std::vector<int> fds(n);
+  std::vector<ulong> size(n);
+  ulong share = (M->bbLimit - M->bbOut) / n;
+  ulong nbbs = (MAX_BBS - M->no_of_bbs - kept) / n;
+  unsigned char *base;
+  unsigned k;
+  ulong i;
+
+  /* Sizing pass, anywhere in the worker's share */
+  for (k = 0; k < n; k++)
+    pids[k] = sgen_spawn(M, addrs, k, n, M->bbOut + k * share, share, nbbs, 
+			 &fds[k], true);
+  for (k = 0; k < n; k++) {
+    read_all(fds[k], &size[k], sizeof(size[k]));
+    close(fds[k]);
+    sgen_wait(pids[k]);
+  }
+
+  /* Final pass, packed */
+  base = M->bbOut;
+  for (k = 0; k < n; k++) {
+    pids[k] = sgen_spawn(M, addrs, k, n, base, share, nbbs, &fds[k], false);
+    base += size[k];
+  }
+
+  base = M->bbOut;
+  for (k = 0; k < n; k++) {
+    std::vector<sgen_entry> entries;
+    std::vector<patch_st> pats;
+    std::vector<ulong> left;
+    ulong used;
+
+    read_all(fds[k], &used, sizeof(used));
+    if (used != size[k])
+      panic("sgen: worker %u emitted %lu bytes, sized at %lu\n", k, used, size[k]);
+    read_all(fds[k], base, used);
+    read_vector(fds[k], entries);
+    read_vector(fds[k], pats);
+    read_vector(fds[k], left);
+    close(fds[k]);
+    sgen_wait(pids[k]);
+
+    for (i = 0; i < entries.size(); i++)
+      merge_bb_entry(M, entries[i].src, entries[i].trans, entries[i].proc);
+    for (i = 0; i < pats.size(); i++) {
+      worklist.insert(pats[i].to);
+      patches.push_back(pats[i]);
+    }
+    for (i = 0; i < left.size(); i++)
+      worklist.insert(left[i]);
+
+    DEBUG(static_pass_addr_trans)
+      printf("Worker %u: %lu bytes at %lx, %lu entries, %lu patches, %lu left\n",
+	     k, used, (unsigned long)base, (ulong)entries.size(), 
+	     (ulong)pats.size(), (ulong)left.size());
+    base += used;
+  }
+  M->bbOut = base;
+}
+#endif /* SGEN_PARALLEL */
+
 int
 main(int argc, char **argv)
 {
@@ -112,11 +608,33 @@ main(int argc, char **argv)
   typedef struct patch_st patch_st;
   AvlTree<ulong> worklist;
   AvlNode<ulong> *neip;
-  AvlMap<ulong, patch_st> patches;
-  AvlMapNode<ulong, patch_st> *pat;
+  std::vector<patch_st> patches;
+  sgen_pending pend = { 0, 0 };
+
+  unsigned jobs = 1;
+  std::vector<profile_entry> hot;
+
+  while((argc >= 4) && (argv[1][0] == '-')) {
+    if(strcmp(argv[1], "-j") == 0) {
+      jobs = strtoul(argv[2], NULL, 0);
+      if(jobs == 0)
+	jobs = 1;
+    }
+    else if(strcmp(argv[1], "-p") == 0)
+      read_profile(argv[2], hot);
+    else
+      break;
+    argv += 2;
+    argc -= 2;
+  }
 
   if(argc != 2)
-    panic("Usage: sgen <filename>");
+    panic("Usage: sgen [-j jobs] [-p profile] <filename>");
+
+#ifndef SGEN_PARALLEL
+  if(jobs > 1)
+    printf("sgen: parallel translation is not supported in this build\n");
+#endif
 
   bfd_init();
   if(!bfd_set_default_target(target))
@@ -140,34 +658,81 @@ main(int argc, char **argv)
   
   /* bfd_map_over_sections(abfd, show_sections, NULL); */
   
-  /* Get Basic Block start addresses from the file bbaddrs */
-  F = fopen("bbaddrs", "r");
-  if(F == NULL)
-    panic("No bbaddrs found\n");
+  find_entries(abfd, worklist);
 
-  while(fscanf(F, "%lx", &addr) != EOF)
-    worklist.insert(addr);
-  unsigned long sec_size;
-  unsigned long nsections = abfd->section_count;
+  /* Add Basic Block start addresses from the file bbaddrs, if there is
+     one (say from a profiling run) */
+  F = fopen("bbaddrs", "r");
+  if(F != NULL) {
+    while(fscanf(F, "%lx", &addr) == 1)
+      worklist.insert(addr);
+    fclose(F);
+  }
   unsigned long start = bfd_get_start_address(abfd);
   machine_t *M = init_translator(start);
-  M->nsections = nsections;
-  M->sec_info = get_into_mem(abfd);
+  M->sec_info = map_code_segments(argv[1], &M->nsections);
+  M->curr_sec_index = 0;
   /* This is technically not necessary. But I just thought of beginning
      the translation from the first instruction ... */
   xlate_bb(M);
-  M->patch_count = 0;
-  for(i=0; i<M->patch_count; i++) {
-      worklist.insert((unsigned long) M->patch_array[i].to);
-      patch_st *p = new patch_st;
-      p->at = (unsigned long)M->patch_array[i].at;
-      p->to = (unsigned long)M->patch_array[i].to;
-      p->proc_addr = (unsigned long)M->patch_array[i].proc_addr;
-      patches.insert((unsigned long)M->patch_array[i].to, *p); 
+  take_patches(M, worklist, patches);
+
+  /* Translation stops short of the end of the cache, keeping room for
+     the patch blocks of the patch points that are left over */
+  const unsigned char *limit = M->bbLimit;
+
+  /* Profiled blocks first, hottest first, so that the code that a run
+     needs sits together at the start of the cache, ahead of the cold
+     code found from the worklist */
+  if(!hot.empty()) {
+    unsigned char *hot_start = M->bbOut;
+    ulong j;
+
+    for(j = 0; j < hot.size(); j++) {
+      if(!sgen_room(M, limit, pend, patches))
+	break;
+      if(!in_code(abfd, hot[j].addr))
+	continue;
+      M->fixregs.eip = hot[j].addr;
+      xlate_bb(M);
+      take_patches(M, worklist, patches);
     }
-  M->patch_count = 0;
+    printf("sgen: %lu of %lu profiled blocks, %lu bytes of hot code\n", j, 
+	   (ulong)hot.size(), (ulong)(M->bbOut - hot_start));
+  }
 
   while((neip = worklist.least()) != NULL) {
+    /* Stop short of xlate_bb wiping the cache; what is left is
+       translated at run time */
+    if(!sgen_room(M, limit, pend, patches)) {
+      printf("sgen: cache full, stopped at %lx\n", neip->key);
+      break;
+    }
+
+#ifdef SGEN_PARALLEL
+    if(jobs > 1) {
+      std::vector<ulong> addrs;
+      while((neip = worklist.least()) != NULL) {
+	addrs.push_back(neip->key);
+	worklist.remove(*neip);
+      }
+      if(addrs.size() >= jobs * SGEN_MIN_PER_JOB) {
+	unsigned char *out = M->bbOut;
+	sgen_round(M, addrs, jobs, pending_bound(pend, patches), worklist, 
+		   patches);
+	/* Once the shares of the workers are too small to take a trace,
+	   go on one at a time until the cache is full */
+	if(M->bbOut == out)
+	  jobs = 1;
+	continue;
+      }
+      /* Too little to go round, back to one at a time */
+      for(ulong j = 0; j < addrs.size(); j++)
+	worklist.insert(addrs[j]);
+      neip = worklist.least();
+    }
+#endif
+
     DEBUG(static_pass_addr_trans)
       printf("Translating %lx\n", neip->key); 
     
@@ -176,24 +741,21 @@ main(int argc, char **argv)
     xlate_bb(M);    
 
     /* Add Contents of Patch_array to Worklist
-       Add patch information to a AVL-Map */
-    for(i=0; i<M->patch_count; i++) {
-      worklist.insert((unsigned long) M->patch_array[i].to);
-      patch_st *p = new patch_st;
-      p->at = (unsigned long)M->patch_array[i].at;
-      p->to = (unsigned long)M->patch_array[i].to;
-      p->proc_addr = (unsigned long)M->patch_array[i].proc_addr;
-      patches.insert((unsigned long)M->patch_array[i].to, *p); 
-    }
-    M->patch_count = 0;
+       and keep the patch points for the end */
+    take_patches(M, worklist, patches);
   }
   
-  /* Now patch all of the patch points together */
-  while((pat = patches.least()) != NULL) {
-    patch_st *p = &pat->value;
+  /* Now patch all of the patch points together, into the room kept
+     for the patch blocks of those whose target was not translated */
+  M->bbLimit = limit;
+  for(i = 0; i < (int)patches.size(); i++) {
+    patch_st *p = &patches[i];
     bb_entry* curr_entry = lookup_bb_eip(M, p->to);
-    if(curr_entry == NULL) {
-      panic("WARNING: %lx Not found while Patching\n", p->to);
+    if((curr_entry == NULL) || (curr_entry->trans_bb_eip == NOT_YET_TRANSLATED)) {
+      DEBUG(static_pass_addr_trans)
+	printf("Patch block for %lx at %lx\n", p->to, p->at);
+
+      sgen_patch_block(M, p->at, p->to, p->proc_addr);
     }
     else {
       DEBUG(static_pass_addr_trans)
@@ -201,7 +763,6 @@ main(int argc, char **argv)
 
       simple_patch(M, p->at, curr_entry->trans_bb_eip);
     }   
-    patches.remove(*pat);    
   }
     
   /* Now dump the M structure */
@@ -64,6 +64,75 @@ bb_emit_w32(machine_t *M, unsigned long ul)
   bb_emit_byte(M, (ul >> 24) & 0xffu);
 }
 
+#ifdef NOTE_SITES
+/* Note a site of the trace being emitted, for the peephole pass and
+   for RECYCLE_TRACES. "at" is the 32-bit field of the instruction
+   starting at "start" */
+INLINE void
+bb_note_site(machine_t *M, unsigned long kind, unsigned char *start, unsigned char *at)
+{
+  if (!M->pp_active)
+    return;
+
+  if (M->pp_count < PP_ARRAY_LEN) {
+    M->pp_array[M->pp_count].start = start;
+    M->pp_array[M->pp_count].at = at;
+    M->pp_array[M->pp_count].kind = kind;
+    M->pp_count++;
+  }
+  else
+    M->pp_overflow = true;
+}
+#endif /* NOTE_SITES */
+
+/* Emit n bytes of padding, using the longest flag-preserving
+   no-ops the decoder knows about */
+INLINE void
+bb_emit_nops(machine_t *M, unsigned long n)
+{
+  while (n >= 7) {
+    /* leal 0(%esi,%eiz,1), %esi */
+    bb_emit_byte(M, 0x8du);
+    bb_emit_byte(M, 0xB4u); /* 10 110 100 */
+    bb_emit_byte(M, 0x26u); /* 00 100 110 */
+    bb_emit_w32(M, 0);
+    n -= 7;
+  }
+
+  switch (n) {
+  case 6:
+    /* leal 0(%esi), %esi */
+    bb_emit_byte(M, 0x8du);
+    bb_emit_byte(M, 0xB6u); /* 10 110 110 */
+    bb_emit_w32(M, 0);
+    break;
+  case 5:
+    bb_emit_byte(M, 0x90u);
+    /* fall through */
+  case 4:
+    /* leal 0(%esi,%eiz,1), %esi */
+    bb_emit_byte(M, 0x8du);
+    bb_emit_byte(M, 0x74u); /* 01 110 100 */
+    bb_emit_byte(M, 0x26u); /* 00 100 110 */
+    bb_emit_byte(M, 0x00u);
+    break;
+  case 3:
+    /* leal 0(%esi), %esi */
+    bb_emit_byte(M, 0x8du);
+    bb_emit_byte(M, 0x76u); /* 01 110 110 */
+    bb_emit_byte(M, 0x00u);
+    break;
+  case 2:
+    /* xchg %ax, %ax */
+    bb_emit_byte(M, 0x66u);
+    bb_emit_byte(M, 0x90u);
+    break;
+  case 1:
+    bb_emit_byte(M, 0x90u);
+    break;
+  }
+}
+
 INLINE void
 bb_emit_jump(machine_t *M, unsigned char *dest)
 {
@@ -79,6 +148,12 @@ bb_emit_jump(machine_t *M, unsigned char *dest)
   next_instr = (unsigned long) M->bbOut + 4;
   moffset = (unsigned long)dest - next_instr;
   bb_emit_w32(M, moffset);
+
+#ifdef NOTE_SITES
+  /* A zero destination is a patch point, noted by the caller */
+  if (dest != 0)
+    bb_note_site(M, PP_REL32, M->bbOut - 5, M->bbOut - 4);
+#endif
 }
 
 INLINE void
@@ -96,11 +171,18 @@ bb_emit_call(machine_t *M, unsigned char *dest)
   next_instr = (unsigned long) M->bbOut + 4;
   moffset = (unsigned long)dest - next_instr;
   bb_emit_w32(M, moffset);
+
+#ifdef NOTE_SITES
+  bb_note_site(M, PP_REL32, M->bbOut - 5, M->bbOut - 4);
+#endif
 }
 
 INLINE void
 bb_emit_save_reg_to(machine_t *M, unsigned long whichReg, unsigned long addr)
 {
+#ifdef NOTE_ADDR_SITES
+  unsigned char *start = M->bbOut;
+#endif
   //bb_emit_byte(M, 0x65u); /* GS Segment Override Prefix - for accessing the M structure */
 
   switch(whichReg) {
@@ -147,11 +229,18 @@ bb_emit_save_reg_to(machine_t *M, unsigned long whichReg, unsigned long addr)
     panic("bb_emit_save_reg_to() called with unknown register\n");
     break;
   }
+
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_MABS32, start, M->bbOut - 4);
+#endif
 }
 
 INLINE void
 bb_emit_16_bit_save_reg_to(machine_t *M, unsigned long whichReg, unsigned long addr)
 {
+#ifdef NOTE_ADDR_SITES
+  unsigned char *start = M->bbOut;
+#endif
   //bb_emit_byte(M, 0x65u); /* GS Segment Override Prefix - for accessing the M structure */
 
   switch(whichReg) {
@@ -206,11 +295,18 @@ bb_emit_16_bit_save_reg_to(machine_t *M, unsigned long whichReg, unsigned long a
     panic("bb_emit_save_reg_to() called with unknown register\n");
     break;
   }
+
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_MABS32, start, M->bbOut - 4);
+#endif
 }
 
 INLINE void
 bb_emit_restore_reg_from(machine_t *M, unsigned long whichReg, unsigned long addr)
 {
+#ifdef NOTE_ADDR_SITES
+  unsigned char *start = M->bbOut;
+#endif
   //bb_emit_byte(M, 0x65u); /* GS Segment Override Prefix - for accessing the M structure */
 
   switch(whichReg) {
@@ -257,6 +353,10 @@ bb_emit_restore_reg_from(machine_t *M, unsigned long whichReg, unsigned long add
     panic("bb_emit_restore_reg_from() called with unknown register\n");
     break;
   }
+
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_MABS32, start, M->bbOut - 4);
+#endif
 }
 
 INLINE void
@@ -344,6 +444,9 @@ bb_emit_store_immediate_to(machine_t *M, unsigned long imm, unsigned long dest)
   bb_emit_byte(M, 0x05u); /* 00 000 101 */
   bb_emit_w32(M, dest);   /* M dest */
   bb_emit_w32(M, imm);    /* imm32 */
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_MABS32, M->bbOut - 10, M->bbOut - 8);
+#endif
 }
 
 /**************************************************************************************************************/
@@ -46,6 +46,11 @@ extern void bb_emit_jump(machine_t *M, unsigned char *dest);
 extern void bb_emit_ijump(machine_t *M, unsigned long ul);
 
 extern void bb_emit_call(machine_t *M, unsigned char *dest);
+extern void bb_emit_nops(machine_t *M, unsigned long n);
+#ifdef NOTE_SITES
+extern void bb_note_site(machine_t *M, unsigned long kind, 
+			 unsigned char *start, unsigned char *at);
+#endif
 
 extern void bb_emit_indirect_through_reg(machine_t *M, unsigned long reg);
 
@@ -55,6 +55,14 @@
 #include <stdlib.h>
 #include <sched.h>
 #include <asm/unistd.h>
+#ifdef PREFETCH_DUMP_PAGES
+#include <sys/mman.h>
+#endif
+#if defined(USE_STATIC_DUMP) || defined(STATIC_PASS) || defined(PERSIST_TRACES)
+#define __USE_GNU
+#include <link.h>
+#undef __USE_GNU
+#endif
 
 #ifdef INLINE_EMITTERS
 #define INLINE static inline
@@ -112,15 +120,404 @@ Emit INT - To capture exit only
 #define ENABLE_DUMP_FUNCTION
 #endif
 
+#if defined(ENABLE_DUMP_FUNCTION) || defined(PERSIST_TRACES)
+/* Identities of the code that a dump depends upon: the build-id of an
+   ELF module if it has one, or else a hash of its executable
+   segments */
+
+#define DUMP_HASH_INIT 0xcbf29ce484222325ull
+
+/* FNV-1a */
+static unsigned long long
+dump_hash(unsigned long long h, const unsigned char *p, unsigned long len)
+{
+  while (len--) {
+    h ^= *p++;
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+static void
+dump_hash_id(unsigned long long h, unsigned char *id)
+{
+  memset(id, 0, DUMP_ID_LEN);
+  memcpy(id, &h, sizeof(h));
+}
+
+/* Copy the build-id found among the notes [p, p + len) to id */
+static bool
+dump_note_id(const unsigned char *p, unsigned long len, unsigned char *id)
+{
+  const unsigned char *end = p + len;
+  const unsigned char *name, *desc;
+  const Elf32_Nhdr *n;
+
+  while (p + sizeof(Elf32_Nhdr) <= end) {
+    n = (const Elf32_Nhdr *)p;
+    name = p + sizeof(Elf32_Nhdr);
+    desc = name + ((n->n_namesz + 3) & ~3u);
+    p = desc + ((n->n_descsz + 3) & ~3u);
+    if (p > end)
+      break;
+
+    if ((n->n_type == NT_GNU_BUILD_ID) && (n->n_namesz == 4) &&
+	(memcmp(name, "GNU", 4) == 0)) {
+      memset(id, 0, DUMP_ID_LEN);
+      memcpy(id, desc, (n->n_descsz < DUMP_ID_LEN) ? n->n_descsz : DUMP_ID_LEN);
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Of a module as it is mapped */
+void
+dump_module_id(struct dl_phdr_info *info, unsigned char *id)
+{
+  unsigned long long h = DUMP_HASH_INIT;
+  unsigned long i;
+
+  for (i = 0; i < info->dlpi_phnum; i++) {
+    const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+    if ((ph->p_type == PT_NOTE) &&
+	dump_note_id((unsigned char *)(info->dlpi_addr + ph->p_vaddr), 
+		     ph->p_filesz, id))
+      return;
+  }
+
+  for (i = 0; i < info->dlpi_phnum; i++) {
+    const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+    if ((ph->p_type == PT_LOAD) && (ph->p_flags & PF_X))
+      h = dump_hash(h, (unsigned char *)(info->dlpi_addr + ph->p_vaddr), 
+		    ph->p_filesz);
+  }
+  dump_hash_id(h, id);
+}
+
+static int
+dump_find_xlate(struct dl_phdr_info *info, size_t size, void *id)
+{
+  unsigned long addr = (unsigned long)&dump_xlate_id;
+  unsigned long i;
+
+  for (i = 0; i < info->dlpi_phnum; i++) {
+    const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+    if ((ph->p_type == PT_LOAD) && (addr >= info->dlpi_addr + ph->p_vaddr) &&
+	(addr < info->dlpi_addr + ph->p_vaddr + ph->p_memsz)) {
+      dump_module_id(info, id);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Of the module that the translator is part of */
+void
+dump_xlate_id(unsigned char *id)
+{
+  memset(id, 0, DUMP_ID_LEN);
+  dl_iterate_phdr(dump_find_xlate, id);
+}
+
+/* Of an ELF file, the same as dump_module_id gives once it is mapped */
+bool
+dump_file_id(const char *path, unsigned char *id)
+{
+  unsigned long long h = DUMP_HASH_INIT;
+  unsigned char buf[4096];
+  Elf32_Ehdr eh;
+  Elf32_Phdr ph;
+  unsigned long i, off, len;
+  bool found = false;
+  int fd = open(path, O_RDONLY);
+
+  if (fd == -1)
+    return false;
+  if ((pread(fd, &eh, sizeof(eh), 0) != sizeof(eh)) ||
+      (memcmp(eh.e_ident, ELFMAG, SELFMAG) != 0)) {
+    close(fd);
+    return false;
+  }
+
+  for (i = 0; (i < eh.e_phnum) && !found; i++) {
+    if (pread(fd, &ph, sizeof(ph), eh.e_phoff + i * eh.e_phentsize) != sizeof(ph))
+      break;
+    len = (ph.p_filesz < sizeof(buf)) ? ph.p_filesz : sizeof(buf);
+    if ((ph.p_type == PT_NOTE) && (pread(fd, buf, len, ph.p_offset) == len))
+      found = dump_note_id(buf, len, id);
+  }
+
+  for (i = 0; (i < eh.e_phnum) && !found; i++) {
+    if (pread(fd, &ph, sizeof(ph), eh.e_phoff + i * eh.e_phentsize) != sizeof(ph))
+      break;
+    if ((ph.p_type != PT_LOAD) || !(ph.p_flags & PF_X))
+      continue;
+    for (off = 0; off < ph.p_filesz; off += len) {
+      len = ph.p_filesz - off;
+      if (len > sizeof(buf))
+	len = sizeof(buf);
+      if (pread(fd, buf, len, ph.p_offset + off) != len)
+	break;
+      h = dump_hash(h, buf, len);
+    }
+  }
+  close(fd);
+
+  if (!found)
+    dump_hash_id(h, id);
+  return true;
+}
+#endif /* ENABLE_DUMP_FUNCTION || PERSIST_TRACES */
+
 #ifdef ENABLE_DUMP_FUNCTION
+static int
+dump_add_module(struct dl_phdr_info *info, size_t size, void *data)
+{
+  bb_dump_header *h = (bb_dump_header *)data;
+  const char *name = info->dlpi_name ? info->dlpi_name : "";
+
+  /* One too many, and the dump will not be used */
+  if (h->nmodules > DUMP_MODULES_MAX)
+    return 1;
+  if (h->nmodules < DUMP_MODULES_MAX) {
+    h->modules[h->nmodules].name_hash = 
+      (unsigned long)dump_hash(DUMP_HASH_INIT, (const unsigned char *)name, strlen(name));
+    h->modules[h->nmodules].base = info->dlpi_addr;
+  }
+  h->nmodules++;
+  return 0;
+}
+
+/* Where the modules are mapped. The static pass only translates the
+   executable, which has to be loaded where it was linked (a PIE is
+   not) */
+static void
+dump_layout(bb_dump_header *h)
+{
+  h->nmodules = 0;
+#ifdef STATIC_PASS
+  h->nmodules = 1;
+  h->modules[0].name_hash = (unsigned long)dump_hash(DUMP_HASH_INIT, NULL, 0);
+  h->modules[0].base = 0;
+#else
+  dl_iterate_phdr(dump_add_module, h);
+#endif
+}
+
+#define DUMP_PAGE_DOWN(x) ((x) & ~(PAGE_SIZE - 1))
+#define DUMP_PAGE_UP(x)   DUMP_PAGE_DOWN((x) + PAGE_SIZE - 1)
+
+/* Add the pages of M from lo to hi to h's sections, unless an earlier
+   section has them already */
+static void
+dump_add_section(bb_dump_header *h, unsigned long lo, unsigned long hi)
+{
+  dump_section *s = &h->sections[h->nsections];
+  unsigned long file_off = 0;
+
+  lo = DUMP_PAGE_DOWN(lo);
+  hi = DUMP_PAGE_UP(hi);
+  if (h->nsections > 0) {
+    dump_section *prev = s - 1;
+    if (lo < prev->start + prev->len)
+      lo = prev->start + prev->len;
+    file_off = prev->file_off + prev->len;
+  }
+  if (hi <= lo)
+    return;
+  s->start = lo;
+  s->len = hi - lo;
+  s->file_off = file_off;
+  h->nsections++;
+}
+
+static void
+dump_sections(machine_t *M, bb_dump_header *h)
+{
+  h->nsections = 0;
+  dump_add_section(h, 0, M->bbOut - (unsigned char *)M);
+  dump_add_section(h, offsetof(machine_t, lookup_table),
+		   (unsigned char *)&M->bb_entry_nodes[M->no_of_bbs] - 
+		   (unsigned char *)M);
+  dump_add_section(h, offsetof(machine_t, patch_array), h->machine_size);
+}
+
+/* Write section s of M. pt_state is written as though it followed M,
+   as it does once the dump is mapped back */
+static bool
+dump_write_section(int fd, machine_t *M, dump_section *s)
+{
+  unsigned long lo = s->start;
+  unsigned long hi = s->start + s->len;
+  unsigned long n;
+
+  if (hi > sizeof(machine_t) + sizeof(pt_state))
+    hi = sizeof(machine_t) + sizeof(pt_state);
+  if (lo < sizeof(machine_t)) {
+    n = ((hi < sizeof(machine_t)) ? hi : sizeof(machine_t)) - lo;
+    if (pwrite(fd, ((unsigned char *)M) + lo, n, s->file_off) != n)
+      return false;
+    lo += n;
+  }
+  if (lo < hi) {
+    n = hi - lo;
+    if (pwrite(fd, ((unsigned char *)M->ptState) + (lo - sizeof(machine_t)),
+	       n, s->file_off + (lo - s->start)) != n)
+      return false;
+  }
+  return true;
+}
+
+#ifdef SHARED_DUMP_CODE
+/* The pages of M's code that are mapped shared when its dump is
+   reloaded */
+void
+dump_shared_range(machine_t *M, unsigned char **lo, unsigned char **hi)
+{
+  *lo = (unsigned char *)DUMP_PAGE_UP((unsigned long)M->bbCache_main);
+  *hi = (unsigned char *)DUMP_PAGE_DOWN((unsigned long)M->bbOut);
+}
+
+/* Write the word w at p in M to where p is in the dump described by h */
+static bool
+dump_patch_word(int fd, machine_t *M, bb_dump_header *h, 
+		unsigned char *p, unsigned long w)
+{
+  unsigned long off = p - (unsigned char *)M;
+  unsigned long i;
+
+  for (i = 0; i < h->nsections; i++) {
+    dump_section *s = &h->sections[i];
+    if ((off >= s->start) && (off + 4 <= s->start + s->len))
+      return (pwrite(fd, &w, 4, s->file_off + (off - s->start)) == 4);
+  }
+  return false;
+}
+
+/* Code that is mapped shared cannot be patched once the dump is
+   reloaded. So, in the file only, send each unlinked exit from it
+   through a stub of its own in M->shared_stubs, a JMP to the exit's
+   patch block, and have the patch block patch the stub instead of the
+   exit. Exits that an earlier dump sent through a stub keep it */
+static bool
+dump_redirect_exits(int fd, machine_t *M, bb_dump_header *h)
+{
+  unsigned char *lo, *hi, *pb, *at, *stub;
+  unsigned long n = M->shared_nstubs;
+  bool ok = true;
+
+  dump_shared_range(M, &lo, &hi);
+  for (pb = M->bbCache_main; ok && (pb + PATCH_BLOCK_LEN <= M->bbOut) && 
+	 (n < SHARED_STUBS_MAX); pb++) {
+    if ((pb[0] != 0xE8u) || 
+	(*((unsigned long *)(pb + 1)) != 
+	 (unsigned long)(M->backpatch_and_dispatch_bb - (pb + 5))))
+      continue;
+    at = *((unsigned char **)(pb + 9));
+    if ((at < lo) || (at + 4 > hi) || 
+	(*((unsigned long *)at) != (unsigned long)(pb - (at + 4))))
+      continue;
+
+    stub = M->shared_stubs[n++];
+    ok = dump_patch_word(fd, M, h, stub, 0xE9u) &&
+      dump_patch_word(fd, M, h, stub + 1, pb - (stub + 5)) &&
+      dump_patch_word(fd, M, h, at, stub - (at + 4)) &&
+      dump_patch_word(fd, M, h, pb + 9, (unsigned long)(stub + 1));
+    pb += PATCH_BLOCK_LEN - 1;
+  }
+  if (ok && (n != M->shared_nstubs))
+    ok = dump_patch_word(fd, M, h, (unsigned char *)&M->shared_nstubs, n);
+
+  DEBUG(dump)
+    fprintf(DBG, "Sent %lu exits of shared code through stubs\n", 
+	    n - M->shared_nstubs);
+  return ok;
+}
+#endif /* SHARED_DUMP_CODE */
+
+/* Are h's sections ones that dump_sections could have made? */
+static bool
+dump_sections_ok(bb_dump_header *h)
+{
+  unsigned long i, end = 0, file_end = 0;
+
+  if ((h->nsections == 0) || (h->nsections > DUMP_SECTIONS) ||
+      (h->sections[0].file_off != 0))
+    return false;
+  for (i = 0; i < h->nsections; i++) {
+    dump_section *s = &h->sections[i];
+    if ((s->start % PAGE_SIZE) || (s->len % PAGE_SIZE) || 
+	(s->file_off != file_end) || (s->start < end) || (s->len == 0) ||
+	(s->start + s->len > DUMP_PAGE_UP(h->machine_size)))
+      return false;
+    end = s->start + s->len;
+    file_end += s->len;
+  }
+  return true;
+}
+
+/* Was the dump described by h made from this translator and this
+   guest, mapped as it is now? Modules mapped after startup (dlopen)
+   cannot be checked here, so a dump that has any is not used. Nor is a
+   dump used if ASLR has moved anything, the vdso included */
+bool
+dump_header_ok(bb_dump_header *h)
+{
+  static const unsigned char none[DUMP_ID_LEN];
+  unsigned char id[DUMP_ID_LEN];
+  bb_dump_header now;
+  const char *why = NULL;
+  unsigned long i, j;
+
+  if ((h->magic != DUMP_MAGIC) || (h->version != DUMP_VERSION) ||
+      (h->bbCache_size != BBCACHE_SIZE) || 
+      (h->machine_size != sizeof(machine_t) + sizeof(pt_state)) ||
+      (h->nmodules > DUMP_MODULES_MAX) || !dump_sections_ok(h))
+    why = "format";
+  else {
+    if (memcmp(h->xlate_id, none, DUMP_ID_LEN) != 0) {
+      dump_xlate_id(id);
+      if (memcmp(h->xlate_id, id, DUMP_ID_LEN) != 0)
+	why = "translator";
+    }
+    if ((why == NULL) && 
+	(!dump_file_id("/proc/self/exe", id) || 
+	 (memcmp(h->guest_id, id, DUMP_ID_LEN) != 0)))
+      why = "executable";
+  }
+
+  if (why == NULL) {
+    dump_layout(&now);
+    for (i = 0; (i < h->nmodules) && (why == NULL); i++) {
+      for (j = 0; (j < now.nmodules) && (j < DUMP_MODULES_MAX); j++)
+	if (now.modules[j].name_hash == h->modules[i].name_hash)
+	  break;
+      if ((j == now.nmodules) || (j == DUMP_MODULES_MAX) ||
+	  (now.modules[j].base != h->modules[i].base))
+	why = "mappings";
+    }
+  }
+
+  if (why != NULL) {
+    DEBUG(dump_load)
+      fprintf(DBG, "Dump does not match the %s of this run, starting cold\n", why);
+    return false;
+  }
+  return true;
+}
+
 /* 1) Warning: Will modify str */
 void
 dump_to_file(machine_t *M, char *str)
 {
   char arg[300]; 
+  char tmp[320];
   unsigned long i;
   struct stat buf;
   unsigned long len = strlen(str);
+  bool ok = true;
+  bb_dump_header h;
 
   /* This has to be mmaped eventually ...
      Better abort than buffer overflow */
@@ -129,6 +526,23 @@ dump_to_file(machine_t *M, char *str)
     return;
   }
 
+  /* Before str is changed, it is the path of the executable */
+  memset(&h, 0, sizeof(h));
+  if (!dump_file_id(str, h.guest_id)) {
+    fprintf(DBG, "Cannot read %s; Did not dump.", str);
+    return;
+  }
+  h.magic = DUMP_MAGIC;
+  h.version = DUMP_VERSION;
+  h.bbCache_size = BBCACHE_SIZE;
+  h.machine_size = sizeof(machine_t) + sizeof(pt_state);
+#ifndef STATIC_PASS
+  dump_xlate_id(h.xlate_id);
+#endif
+  h.M = M;
+  dump_layout(&h);
+  dump_sections(M, &h);
+
   for(i=0; i<len; i++)
     if(str[i] == '/')
       str[i] = '_';
@@ -139,24 +553,182 @@ dump_to_file(machine_t *M, char *str)
 #endif
   int fd;
 
-  extrabytes = (sizeof(machine_t) + sizeof(pt_state)) % PAGE_SIZE;
-  
+  /* Other processes may have the old dump mapped: write a new file
+     and put it in place of the old one, rather than truncating it
+     under them */
   sprintf(arg, "/tmp/vdebug-dump/%s-dump", str);
-  fd = open(arg, O_CREAT | O_RDWR | O_TRUNC, S_IRWXU);
-  i = write(fd, M, sizeof(machine_t)); 
-  i = write(fd, M->ptState, sizeof(pt_state)); 
-  i = write(fd, M, extrabytes);  // waste
+  sprintf(tmp, "%s.%d", arg, getpid());
+  fd = open(tmp, O_CREAT | O_RDWR | O_TRUNC, S_IRWXU);
+  if(fd == -1) {
+    fprintf(DBG, "Cannot create %s; Did not dump.", tmp);
+    return;
+  }
+  for(i=0; ok && (i<h.nsections); i++)
+    ok = dump_write_section(fd, M, &h.sections[i]);
+  /* The last section may end past the end of pt_state: the pages it
+     is mapped over have to be in the file */
+  i = h.nsections - 1;
+  if(ok)
+    ok = (ftruncate(fd, h.sections[i].file_off + h.sections[i].len) == 0);
+#ifdef SHARED_DUMP_CODE
+  if(ok)
+    ok = dump_redirect_exits(fd, M, &h);
+#endif
   close(fd);
-  
+  if(!ok) {
+    fprintf(DBG, "Cannot write %s; Did not dump.", tmp);
+    unlink(tmp);
+    return;
+  }
+  rename(tmp, arg);
+
+  DEBUG(dump)
+    fprintf(DBG, "Dumped %lu of %lu bytes of M\n", 
+	    h.sections[i].file_off + h.sections[i].len, h.machine_size);
+
 
   sprintf(arg, "/tmp/vdebug-dump/%s-addr", str);
   fd = open(arg, O_CREAT | O_RDWR | O_TRUNC, S_IRWXU);
-  i = write(fd, &M, sizeof(machine_t *)); 
+  i = write(fd, &h, sizeof(h)); 
   close(fd);
-  
+
+#ifdef PREFETCH_DUMP_PAGES
+  /* The pages used by the old dump say nothing about this one */
+  sprintf(arg, "/tmp/vdebug-dump/%s-pages", str);
+  unlink(arg);
+#endif
 }
 #endif
 
+#ifdef PREFETCH_DUMP_PAGES
+/* <exe>-pages holds the offsets, in pages, of the pages of the dump
+   that the first run to reload it had touched by the time it had
+   translated DUMP_PAGES_XLATES traces (or by its exit, if sooner).
+   Later runs populate those pages before the guest starts, instead of
+   faulting them in one at a time */
+static char dump_pages_file[320];
+static machine_t *dump_pages_M;	/* The reloaded M, until it is recorded */
+static size_t dump_pages_size;
+static unsigned long dump_pages_left; /* Translations until it is recorded */
+
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
+
+static void
+dump_pages_populate(machine_t *M, unsigned long first, unsigned long n)
+{
+  unsigned char *p = ((unsigned char *)M) + first * PAGE_SIZE;
+
+  /* Before Linux 5.14, only read the pages into the page cache */
+  if (madvise(p, n * PAGE_SIZE, MADV_POPULATE_READ) != 0)
+    madvise(p, n * PAGE_SIZE, MADV_WILLNEED);
+}
+
+/* Called when the dump of M (of mapSize bytes), named after str, has
+   just been mapped back */
+void
+dump_pages_load(machine_t *M, size_t mapSize, const char *str)
+{
+  unsigned long pages[512];
+  unsigned long npages = mapSize / PAGE_SIZE;
+  unsigned long first = 0, run = 0, total = 0;
+  size_t n, i;
+  FILE *f;
+
+  sprintf(dump_pages_file, "/tmp/vdebug-dump/%s-pages", str);
+
+  /* Not recorded yet: this run records them */
+  f = fopen(dump_pages_file, "r");
+  if (f == NULL) {
+    dump_pages_M = M;
+    dump_pages_size = mapSize;
+    dump_pages_left = DUMP_PAGES_XLATES;
+    return;
+  }
+  while ((n = fread(pages, sizeof(pages[0]), 512, f)) > 0)
+    for (i = 0; i < n; i++) {
+      if (pages[i] >= npages)
+	continue;
+      total++;
+      if ((run > 0) && (pages[i] == first + run)) {
+	run++;
+	continue;
+      }
+      if (run > 0)
+	dump_pages_populate(M, first, run);
+      first = pages[i];
+      run = 1;
+    }
+  if (run > 0)
+    dump_pages_populate(M, first, run);
+  fclose(f);
+
+  DEBUG(dump_load)
+    fprintf(DBG, "Prefetched %lu of %lu pages of the dump\n", total, npages);
+}
+
+/* Write the pages of the reloaded dump that are mapped in by now. A
+   page is present in /proc/self/pagemap once this process has touched
+   it, or the kernel has mapped it around a page that was touched (at
+   most fault_around_bytes, 64K by default, around each one) */
+void
+dump_pages_record(void)
+{
+  unsigned long long ent[512];
+  unsigned long npages = dump_pages_size / PAGE_SIZE;
+  unsigned long page0 = ((unsigned long)dump_pages_M) / PAGE_SIZE;
+  unsigned long i, j, k, total = 0;
+  char tmp[340];
+  FILE *f;
+  int fd;
+
+  if (dump_pages_M == NULL)
+    return;
+  dump_pages_M = NULL;
+
+  fd = open("/proc/self/pagemap", O_RDONLY);
+  if (fd == -1)
+    return;
+  sprintf(tmp, "%s.%d", dump_pages_file, getpid());
+  f = fopen(tmp, "w");
+  if (f == NULL) {
+    close(fd);
+    return;
+  }
+  for (i = 0; i < npages; i += k) {
+    k = ((npages - i) < 512) ? (npages - i) : 512;
+    if (pread(fd, ent, k * sizeof(ent[0]), 
+	      (off_t)(page0 + i) * sizeof(ent[0])) != k * sizeof(ent[0]))
+      break;
+    for (j = 0; j < k; j++)
+      if (ent[j] & (3ull << 62)) {	/* Present or swapped */
+	unsigned long page = i + j;
+	fwrite(&page, sizeof(page), 1, f);
+	total++;
+      }
+  }
+  close(fd);
+  fclose(f);
+  if (i < npages)
+    unlink(tmp);
+  else
+    rename(tmp, dump_pages_file);
+
+  DEBUG(dump_load)
+    fprintf(DBG, "Recorded %lu of %lu pages of the dump\n", total, npages);
+}
+
+/* From the translator, on each translation into M: record once the
+   reloaded M has had DUMP_PAGES_XLATES */
+void
+dump_pages_check(machine_t *M)
+{
+  if ((M == dump_pages_M) && (--dump_pages_left == 0))
+    dump_pages_record();
+}
+#endif /* PREFETCH_DUMP_PAGES */
+
 void 
 exit_stub(machine_t *M)
 {
@@ -186,8 +758,15 @@ exit_stub(machine_t *M)
   fprintf(f, "Translation Time% = %0.3f\n", 
 	  PERC(M->ptState->trans_time, M->ptState->tot_time));
   fprintf(f, "Total bytes       = %lu\n", (M->bbOut - M->bbCache));  
+  fprintf(f, "Total instructions= %llu\n", M->ptState->trans_instrs);  
+  fprintf(f, "Guest bytes       = %llu\n", M->ptState->trans_bytes);  
+  fprintf(f, "Cycles per instr  = %0.3f\n", 
+	  (float)M->ptState->trans_time / M->ptState->trans_instrs);  
   fprintf(f, "Cycles per byte   = %0.3f\n\n\n", 
 	  (float)M->ptState->trans_time / (M->bbOut - M->bbCache));  
+#ifdef PROFILE_XLATE_PHASES
+  xlate_prof_report(M, f);
+#endif
   fclose(f);
   return;
 #endif
@@ -317,6 +896,32 @@ exit_stub(machine_t *M)
   fprintf(F, "BBCache: Total size 		= %lu\n", BBCACHE_SIZE);
   fprintf(F, "BBCache: No. of Bytes used 	= %lu %0.3f%\n", (M->bbOut-M->bbCache), 
 	  PERC((M->bbOut-M->bbCache), BBCACHE_SIZE));
+#ifdef PEEPHOLE_OPT
+  fprintf(F, "Peephole: Bytes saved 		= %lu\n", M->ptState->pp_bytes_saved);
+  fprintf(F, "Peephole: Jumps removed 	= %lu\n", M->ptState->pp_jmps_removed);
+  fprintf(F, "Peephole: Jumps threaded 	= %lu\n", M->ptState->pp_jmps_threaded);
+  fprintf(F, "Peephole: Traces skipped 	= %lu\n", M->ptState->pp_traces_skipped);
+  fprintf(F, "Peephole: Short branches 	= %lu\n", M->ptState->pp_short_branches);
+#endif
+#ifdef FOLLOW_CALLS
+  fprintf(F, "Calls followed 			= %lu\n", M->ptState->s_calls_followed);
+  fprintf(F, "Instructions in followed calls 	= %lu\n", M->ptState->s_followed_instrs);
+#endif
+#ifdef DECODE_CACHE
+  fprintf(F, "Decode cache hits 		= %lu\n", M->ptState->dcache_hits);
+  fprintf(F, "Decode cache misses 		= %lu\n", M->ptState->dcache_misses);
+#endif
+#ifdef RECYCLE_TRACES
+  fprintf(F, "Traces kept for recycling 	= %lu\n", M->ptState->rc_saved);
+  fprintf(F, "Traces recycled 		= %lu\n", M->ptState->rc_recycled);
+  fprintf(F, "Bytes recycled 			= %lu\n", M->ptState->rc_recycled_bytes);
+#endif
+#ifdef TRACE_ALIGN
+  fprintf(F, "Aligned traces 			= %lu\n", M->ptState->aligned_traces);
+  fprintf(F, "Trace padding bytes 		= %lu\n", M->ptState->align_pad_bytes);
+  fprintf(F, "Aligned loop heads 		= %lu\n", M->ptState->aligned_loops);
+  fprintf(F, "Loop padding bytes 		= %lu\n", M->ptState->loop_pad_bytes);
+#endif
 
   /*   bucket_entry *b = (bucket_entry *)M->hash_table;  */
   /*   unsigned long ch_used_cnt = 0; */
@@ -350,16 +955,26 @@ exit_stub(machine_t *M)
 
 
 #ifdef USE_STATIC_DUMP 
-  if(M->dump == true) {
+  if(M->ptState->dump == true) {
     dump_to_file(M, str);
   }
+#ifdef PREFETCH_DUMP_PAGES
+  else
+    dump_pages_record();
+#endif
+#endif
+
+#if defined(PERSIST_TRACES) && !defined(STATIC_PASS)
+  ps_write_traces(M);
 #endif
 
 #ifdef OUTPUT_BB_STAT
   {
     FILE *F = fopen("bbstat", "w");
-    for(i=0; i<M->no_of_bbs; i++) {
-      fprintf(F, "%lx\n", M->bb_entry_nodes[i].src_bb_eip);
+    if(F != NULL) {
+      for(i=0; i<M->bbstat_count; i++)
+	fprintf(F, "%lx\n", M->bbstat_log[i]);
+      fclose(F);
     }
   }
 #endif
@@ -766,6 +1381,9 @@ machine_t* init_thread_trans(unsigned long program_start);
   // push $M->next_eip [len 5b]
   bb_emit_byte(M, 0x68u);
   bb_emit_w32(M, M->next_eip);
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_GABS32, M->bbOut - 5, M->bbOut - 4);
+#endif
 
   // call init_therad_trans [len 5b]
   bb_emit_call(M, (unsigned char *)(&init_thread_trans)); 
@@ -1106,6 +1724,9 @@ emit_pusha_pushM_call(machine_t *M, void *proc) //[len 19b]
   // Push M [len 5b]
   bb_emit_byte(M, 0x68u);
   bb_emit_w32(M, (unsigned long) M);
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_MABS32, M->bbOut - 5, M->bbOut - 4);
+#endif
   
   // call stub [len 5b]
   bb_emit_call(M, (unsigned char *) proc);
@@ -1637,6 +2258,9 @@ emit_jcond(machine_t *M, decode_t *d)
   bb_emit_w32(M, 0);
 
   note_patch(M, M->bbOut - 4, (unsigned char *)jmp_destn, M->curr_bb_entry->proc_entry);
+#ifdef NOTE_SITES
+  bb_note_site(M, PP_JCC, M->bbOut - ((d->flags & DSFL_GROUP2_PREFIX) ? 7 : 6), M->bbOut - 4);
+#endif
   /*
     M->patch_array[M->patch_count].to = (unsigned char *) jmp_destn;
     M->patch_array[M->patch_count].at = M->bbOut - 4;
@@ -1703,6 +2327,125 @@ emit_jmp(machine_t *M, decode_t *d)
   return continue_trace(M, d, jmp_destn);
 }
 
+#ifdef CALL_RET_OPT
+/* Control comes here with the guest's return address on top of the
+   stack. If it is ret_eip, pop it and fall through, otherwise go
+   dispatch it */
+static void
+emit_return_check(machine_t *M, unsigned long ret_eip)
+{
+  /* push %ecx */
+  bb_emit_byte(M, 0x51u);
+  /* mov 4(%esp) %ecx */
+  bb_emit_byte(M, 0x8bu);
+  bb_emit_byte(M, 0x4cu); // 01 001 100
+  bb_emit_byte(M, 0x24u); // 00 100 100
+  bb_emit_byte(M, 0x4u);
+
+  /* lea -(ret_eip)(%ecx) , %ecx */
+  bb_emit_byte(M, 0x8du); // 8D /r
+  bb_emit_byte(M, 0x89u); // 10 001 001
+  bb_emit_w32(M, (-((long)ret_eip)));
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_GNEG32, M->bbOut - 6, M->bbOut - 4);
+#endif
+
+#ifdef SIEVE_WITHOUT_PPF
+  /* jecxz equal */
+  bb_emit_byte(M, 0xe3u);
+  bb_emit_byte(M, 0x5u);
+
+#else  
+  /* jecxz equal */
+  bb_emit_byte(M, 0xe3u);
+  bb_emit_byte(M, 0x6u);
+
+  /* pop ecx */
+  bb_emit_byte(M, 0x59u);
+#endif /* SIEVE_WITHOUT_PPF */
+
+  /* jmp fast_dispatch */
+  bb_emit_jump(M, M->call_calls_fast_dispatch_bb);
+
+  /* equal: pop ecx */
+  bb_emit_byte(M, 0x59u);
+
+  // esp += 4; leal 4(%esp), %esp
+  bb_emit_byte(M, 0x8du);
+  bb_emit_byte(M, 0xA4u); /* 10 100 100 */
+  bb_emit_byte(M, 0x24u); /* 00 100 100 */
+  bb_emit_w32(M, 0x4u);
+#ifdef NOTE_SITES
+  bb_note_site(M, PP_LEA4, M->bbOut - 7, M->bbOut - 4);
+#endif
+}
+#endif /* CALL_RET_OPT */
+
+#if defined(FOLLOW_CALLS) && defined(CALL_RET_OPT) && !defined(STATIC_PASS)
+/* Is the callee a straight run of normal instructions ending in a
+   plain ret? If so, return the number of instructions before the ret
+   and leave all of them, ret included, in body[]. Otherwise return
+   -1. M->next_eip is left as it was */
+static int
+scan_leaf_callee(machine_t *M, unsigned long callee_eip, decode_t *body)
+{
+  unsigned long saved_eip = M->next_eip;
+  int i, n = -1;
+
+  M->next_eip = callee_eip;
+  for (i = 0; i < FOLLOW_CALL_MAX_INSTRS; i++) {
+    if (do_decode(M, &body[i]) == false)
+      break;
+    if ((void *)body[i].emitfn == (void *)emit_ret) {
+      if (THIRTY_TWO_BIT_INSTR((&body[i])))
+	n = i;
+      break;
+    }
+    if ((void *)body[i].emitfn != (void *)emit_normal)
+      break;
+  }
+  M->next_eip = saved_eip;
+  return n;
+}
+
+/* Copy a short leaf callee into the trace, right after the push of
+   its return address. The callee sees the same stack as it would
+   have otherwise, and its ret checks that it is going back to the
+   call site before falling through into the return site */
+static bool
+follow_call(machine_t *M, decode_t *d, unsigned long callee_eip)
+{
+  decode_t body[FOLLOW_CALL_MAX_INSTRS];
+  unsigned long ret_eip = M->next_eip;
+  int i, n;
+
+  if (!THIRTY_TWO_BIT_INSTR(d))
+    return false;
+
+  n = scan_leaf_callee(M, callee_eip, body);
+  if ((n < 0) ||
+      ((M->bbLimit - M->bbOut) <= (long)(BYTES_NEEDED_AT_THE_END + n * MAX_BYTES_PER_INSTR)))
+    return false;
+
+  DEBUG(emits)
+    fprintf(DBG, "%lu: Call-Dir followed into %lx, %d instrs\n", M->nTrInstr, callee_eip, n);
+
+#ifdef PROFILE
+  M->ptState->s_calls_followed++;
+  M->ptState->s_followed_instrs += n;
+#endif
+
+  for (i = 0; i < n; i++) {
+    M->next_eip = body[i+1].decode_eip;
+    emit_normal(M, &body[i]);
+  }
+
+  M->next_eip = ret_eip;
+  emit_return_check(M, ret_eip);
+  return true;
+}
+#endif /* FOLLOW_CALLS && CALL_RET_OPT && !STATIC_PASS */
+
 bool
 emit_call_disp(machine_t *M, decode_t *d)
 {
@@ -1730,15 +2473,33 @@ emit_call_disp(machine_t *M, decode_t *d)
   /* We just Push */
   bb_emit_byte(M, 0x68u);	/* PUSH */
   bb_emit_w32(M, M->next_eip);
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_GABS32, M->bbOut - 5, M->bbOut - 4);
+#endif
+
+#if defined(FOLLOW_CALLS) && defined(CALL_RET_OPT) && !defined(STATIC_PASS)
+  if (follow_call(M, d, jmp_destn)) {
+#ifdef PROFILE_BB_STATS
+    M->curr_bb_entry->flags |= NEEDS_RELOC;
+#endif
+    return continue_trace(M, d, M->next_eip);
+  }
+#endif
 
 #ifdef CALL_RET_OPT
   /* MOV M->proc_hash_table[callee_index], expected_return_address */
   //  fprintf(DBG, "Came in Disp 1\n");
   bb_emit_store_immediate_to(M, (unsigned long)(M->bbOut + 10 + 5), hash_entry_addr);  
+#ifdef NOTE_SITES
+  bb_note_site(M, PP_ABS32, M->bbOut - 10, M->bbOut - 4);
+#endif
 #endif
 
   bb_emit_jump (M, 0);		/* Dummy jump instruction which would be patched later by the translator */
   note_patch(M, M->bbOut - 4, (unsigned char *)jmp_destn, hash_entry_addr);
+#ifdef NOTE_SITES
+  bb_note_site(M, PP_JMP, M->bbOut - 5, M->bbOut - 4);
+#endif
 
   DEBUG(call_ret_opt) 
     fprintf(DBG, "Encountered a CALL(%lx); set Patch Block[%d]'s proc_addr to %lx\n", jmp_destn, M->patch_count, hash_entry_addr);
@@ -1747,45 +2508,7 @@ emit_call_disp(machine_t *M, decode_t *d)
   /* - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
   //fprintf(DBG, "Came in Disp 2\n");
-  /* push %ecx */
-  bb_emit_byte(M, 0x51u);
-  /* mov 4(%esp) %ecx */
-  bb_emit_byte(M, 0x8bu);
-  bb_emit_byte(M, 0x4cu); // 01 001 100
-  bb_emit_byte(M, 0x24u); // 00 100 100
-  bb_emit_byte(M, 0x4u);
-
-  /* lea -(M->next_eip)(%ecx) , %ecx */
-  bb_emit_byte(M, 0x8du); // 8D /r
-  bb_emit_byte(M, 0x89u); // 10 001 001
-  bb_emit_w32(M, (-((long)M->next_eip)));
-
-#ifdef SIEVE_WITHOUT_PPF
-  /* jecxz equal */
-  bb_emit_byte(M, 0xe3u);
-  bb_emit_byte(M, 0x5u);
-
-#else  
-  /* jecxz equal */
-  bb_emit_byte(M, 0xe3u);
-  bb_emit_byte(M, 0x6u);
-
-  /* pop ecx */
-  bb_emit_byte(M, 0x59u);
-#endif /* SIEVE_WITHOUT_PPF */
-
-  /* jmp fast_dispatch */
-  bb_emit_jump(M, M->call_calls_fast_dispatch_bb);
-
-  /* equal: pop ecx */
-  bb_emit_byte(M, 0x59u);
-
-  // esp += 4; leal 4(%esp), %esp
-  bb_emit_byte(M, 0x8du);
-  bb_emit_byte(M, 0xA4u); /* 10 100 100 */
-  bb_emit_byte(M, 0x24u); /* 00 100 100 */
-  bb_emit_w32(M, 0x4u);
-
+  emit_return_check(M, M->next_eip);
 #endif /* CALL_RET_OPT */
 
 #ifdef PROFILE_BB_STATS
@@ -1838,6 +2561,9 @@ emit_call_near_mem(machine_t *M, decode_t *d)
     /* Push M->next_eip */
     bb_emit_byte(M, 0x68u);	/* PUSH */
     bb_emit_w32(M, M->next_eip);
+#ifdef NOTE_ADDR_SITES
+    bb_note_site(M, PP_GABS32, M->bbOut - 5, M->bbOut - 4);
+#endif
 
     bb_emit_push_rm(M, d);
   }
@@ -1867,6 +2593,9 @@ emit_call_near_mem(machine_t *M, decode_t *d)
     bb_emit_byte(M, 0x24u); // 00 100 100
     bb_emit_byte(M, 0x04u);
     bb_emit_w32(M, M->next_eip);    
+#ifdef NOTE_ADDR_SITES
+    bb_note_site(M, PP_GABS32, M->bbOut - 8, M->bbOut - 4);
+#endif
   }
 
 #ifdef CALL_RET_OPT
@@ -1897,6 +2626,12 @@ emit_call_near_mem(machine_t *M, decode_t *d)
   bb_emit_byte(M, 0x8Du);  /* 10 001 101 */
   bb_emit_w32 (M, (unsigned long) M->call_hash_table);
   bb_emit_w32 (M, (((unsigned long)M->bbOut) +  4 + 5));
+#ifdef NOTE_SITES
+  bb_note_site(M, PP_ABS32, M->bbOut - 11, M->bbOut - 4);
+#endif
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_MABS32, M->bbOut - 11, M->bbOut - 8);
+#endif
 
 #ifdef USE_SIEVE
 #ifdef SEPARATE_SIEVES
@@ -1916,6 +2651,12 @@ emit_call_near_mem(machine_t *M, decode_t *d)
   bb_emit_byte(M, 0x8Du);  /* 10 001 101 */
   bb_emit_w32 (M, (unsigned long) M->call_hash_table);
   bb_emit_w32 (M, (((unsigned long)M->bbOut) +  4 + 6));
+#ifdef NOTE_SITES
+  bb_note_site(M, PP_ABS32, M->bbOut - 11, M->bbOut - 4);
+#endif
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_MABS32, M->bbOut - 11, M->bbOut - 8);
+#endif
   
   /* POP %ecx  */
   bb_emit_byte (M, 0x59u);
@@ -1949,6 +2690,9 @@ emit_call_near_mem(machine_t *M, decode_t *d)
   bb_emit_byte(M, 0x8du); // 8D /r
   bb_emit_byte(M, 0x89u); // 10 001 001
   bb_emit_w32(M, (-((long)M->next_eip)));
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_GNEG32, M->bbOut - 6, M->bbOut - 4);
+#endif
 
 #ifdef SIEVE_WITHOUT_PPF
   /* jecxz equal */
@@ -1975,6 +2719,9 @@ emit_call_near_mem(machine_t *M, decode_t *d)
   bb_emit_byte(M, 0xA4u); /* 10 100 100 */
   bb_emit_byte(M, 0x24u); /* 00 100 100 */
   bb_emit_w32(M, 0x4u);
+#ifdef NOTE_SITES
+  bb_note_site(M, PP_LEA4, M->bbOut - 7, M->bbOut - 4);
+#endif
 
 
 #endif /* CALL_RET_OPT */
@@ -2002,6 +2749,9 @@ emit_ret(machine_t *M, decode_t *d)
   bb_emit_byte(M, 0xFFu);
   bb_emit_byte(M, 0x25u);   /* 00 100 101 */
   bb_emit_w32(M, M->curr_bb_entry->proc_entry);
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_MABS32, M->bbOut - 6, M->bbOut - 4);
+#endif
 
 #else
 
@@ -2053,6 +2803,9 @@ emit_ret_Iw(machine_t *M, decode_t *d)
   bb_emit_byte(M, 0xFFu);
   bb_emit_byte(M, 0x25u);   /* 00 100 101 */
   bb_emit_w32(M, M->curr_bb_entry->proc_entry);
+#ifdef NOTE_ADDR_SITES
+  bb_note_site(M, PP_MABS32, M->bbOut - 6, M->bbOut - 4);
+#endif
 
 #else
   /* JMP M->fast_dispatch */
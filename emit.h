@@ -50,12 +50,66 @@ bool emit_call_near_mem(machine_t *M, decode_t *d);
 bool emit_ret(machine_t *M, decode_t *d);
 bool emit_ret_Iw(machine_t *M, decode_t *d);
 
+/* What a dump of M was made from, kept in <exe>-addr. The dump is
+   only mapped back if all of it matches this run */
+#define DUMP_MAGIC        0x504d5644u	/* "DVMP" */
+#define DUMP_VERSION      3
+#define DUMP_ID_LEN       20		/* Long enough for a SHA-1 build-id */
+#define DUMP_MODULES_MAX  64
+#define DUMP_SECTIONS     3
+
+/* The parts of M that are in use are all that is written to <exe>-dump:
+   M up to bbOut (the dispatch code, sieve and traces), the directory
+   and the call table up to bb_entry_nodes[no_of_bbs], and what follows
+   bb_entry_nodes, pt_state included. Each is a run of whole pages of M,
+   at a page-aligned offset in the file, and the first is at offset 0 */
+typedef struct dump_section dump_section;
+struct dump_section {
+  unsigned long start;		/* Offset in M */
+  unsigned long len;
+  unsigned long file_off;
+};
+
+typedef struct dump_module dump_module;
+struct dump_module {
+  unsigned long name_hash;
+  unsigned long base;
+};
+
 typedef struct bb_dump_header bb_dump_header;
 struct bb_dump_header {
+  unsigned long magic;
   unsigned long version;
   unsigned long bbCache_size;
+  unsigned long machine_size;	/* sizeof(machine_t) + sizeof(pt_state) */
+  unsigned char xlate_id[DUMP_ID_LEN]; /* All 0 if made by the static pass */
+  unsigned char guest_id[DUMP_ID_LEN];
+  machine_t *M;			/* Where M was */
+  unsigned long nmodules;	/* Mapped modules, the guest's and ours */
+  dump_module modules[DUMP_MODULES_MAX];
+  unsigned long nsections;
+  dump_section sections[DUMP_SECTIONS];
 };
 
+#if defined(USE_STATIC_DUMP) || defined(STATIC_PASS) || defined(PERSIST_TRACES)
+struct dl_phdr_info;
+
+void dump_module_id(struct dl_phdr_info *info, unsigned char *id);
+void dump_xlate_id(unsigned char *id);
+bool dump_file_id(const char *path, unsigned char *id);
+bool dump_header_ok(bb_dump_header *h);
+#endif
+
+#ifdef SHARED_DUMP_CODE
+void dump_shared_range(machine_t *M, unsigned char **lo, unsigned char **hi);
+#endif
+
+#ifdef PREFETCH_DUMP_PAGES
+void dump_pages_load(machine_t *M, size_t mapSize, const char *str);
+void dump_pages_record(void);
+void dump_pages_check(machine_t *M);
+#endif
+
 #define EMIT_INT80_SYSCALL    0x1u
 #define EMIT_SYSENTER_SYSCALL 0x2u
 
@@ -712,6 +712,372 @@ CONST_TABLE OpCode nopbyte0 [256] = {
   { 0xffu,  "(group)",  0, 0,  0, 0,  0, 0,  ngroup5,   "ngroup5",  2048,  0 },
 };
 
+CONST_TABLE unsigned char twoByteOpcodes_fast [256] = {
+  0x00u, 0x00u, 0x03u, 0x03u, 0x00u, 0x00u, 0x01u, 0x00u, 0x01u, 0x01u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x00u, 0x03u, 0x00u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u,
+  0x01u, 0x01u, 0x01u, 0x01u, 0x00u, 0x01u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x03u, 0x00u, 0x00u, 0x00u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u,
+  0x13u, 0x13u, 0x13u, 0x13u, 0x03u, 0x03u, 0x03u, 0x01u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x03u, 0x03u,
+  0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u,
+  0x01u, 0x01u, 0x01u, 0x03u, 0x13u, 0x03u, 0x00u, 0x00u, 0x01u, 0x01u, 0x01u, 0x03u, 0x13u, 0x03u, 0x03u, 0x03u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x00u, 0x00u, 0x00u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u,
+  0x03u, 0x03u, 0x13u, 0x03u, 0x13u, 0x13u, 0x13u, 0x00u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u,
+  0x00u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u,
+  0x00u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x00u,
+};
+
+CONST_TABLE unsigned char nopbyte0_fast [256] = {
+  0x03u, 0x03u, 0x03u, 0x03u, 0x11u, 0x41u, 0x01u, 0x01u, 0x03u, 0x03u, 0x03u, 0x03u, 0x11u, 0x41u, 0x01u, 0x00u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x11u, 0x41u, 0x01u, 0x01u, 0x03u, 0x03u, 0x03u, 0x03u, 0x11u, 0x41u, 0x01u, 0x01u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x11u, 0x41u, 0x00u, 0x01u, 0x03u, 0x03u, 0x03u, 0x03u, 0x11u, 0x41u, 0x00u, 0x01u,
+  0x03u, 0x03u, 0x03u, 0x03u, 0x11u, 0x41u, 0x00u, 0x01u, 0x03u, 0x03u, 0x03u, 0x03u, 0x11u, 0x41u, 0x00u, 0x01u,
+  0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u,
+  0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u,
+  0x01u, 0x01u, 0x03u, 0x03u, 0x00u, 0x00u, 0x00u, 0x00u, 0x41u, 0x43u, 0x11u, 0x13u, 0x01u, 0x01u, 0x01u, 0x01u,
+  0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+  0x17u, 0x47u, 0x17u, 0x17u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u, 0x03u,
+  0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x61u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u,
+  0x41u, 0x41u, 0x41u, 0x41u, 0x01u, 0x01u, 0x01u, 0x01u, 0x11u, 0x41u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u,
+  0x11u, 0x11u, 0x11u, 0x11u, 0x11u, 0x11u, 0x11u, 0x11u, 0x41u, 0x41u, 0x41u, 0x41u, 0x41u, 0x41u, 0x41u, 0x41u,
+  0x00u, 0x00u, 0x00u, 0x00u, 0x03u, 0x03u, 0x13u, 0x43u, 0x31u, 0x01u, 0x21u, 0x01u, 0x01u, 0x00u, 0x01u, 0x01u,
+  0x00u, 0x00u, 0x00u, 0x00u, 0x11u, 0x11u, 0x00u, 0x01u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u, 0x00u,
+  0x00u, 0x00u, 0x00u, 0x00u, 0x11u, 0x11u, 0x11u, 0x11u, 0x00u, 0x00u, 0x61u, 0x00u, 0x01u, 0x01u, 0x01u, 0x01u,
+  0x00u, 0x00u, 0x00u, 0x00u, 0x01u, 0x01u, 0x00u, 0x00u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x01u, 0x00u, 0x00u,
+};
+
+CONST_TABLE unsigned long group1_Eb_Ib_attr [8] = {
+  0x100003u, 0x100003u, 0x100003u, 0x100003u, 0x100003u, 0x100003u, 0x100003u, 0x100003u,
+};
+
+CONST_TABLE unsigned char group1_Eb_Ib_ptr [8] = {
+    0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+CONST_TABLE unsigned long group1_Ev_Iv_attr [8] = {
+  0x300009u, 0x300009u, 0x300009u, 0x300009u, 0x300009u, 0x300009u, 0x300009u, 0x300009u,
+};
+
+CONST_TABLE unsigned char group1_Ev_Iv_ptr [8] = {
+    0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+CONST_TABLE unsigned long group1_Ev_Ib_attr [8] = {
+  0x300003u, 0x300003u, 0x300003u, 0x300003u, 0x300003u, 0x300003u, 0x300003u, 0x300003u,
+};
+
+CONST_TABLE unsigned char group1_Ev_Ib_ptr [8] = {
+    0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+CONST_TABLE unsigned long group2a_Eb_Ib_attr [8] = {
+  0x100003u, 0x100003u, 0x100003u, 0x100003u, 0x100003u, 0x100003u, 0x000200u, 0x100003u,
+};
+
+CONST_TABLE unsigned char group2a_Eb_Ib_ptr [8] = {
+    0,   0,   0,   0,   0,   0,   1,   0,
+};
+
+CONST_TABLE unsigned long group2a_Ev_Ib_attr [8] = {
+  0x300003u, 0x300003u, 0x300003u, 0x300003u, 0x300003u, 0x300003u, 0x000200u, 0x300003u,
+};
+
+CONST_TABLE unsigned char group2a_Ev_Ib_ptr [8] = {
+    0,   0,   0,   0,   0,   0,   1,   0,
+};
+
+CONST_TABLE unsigned long group2_Eb_1_attr [8] = {
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x000200u, 0x100001u,
+};
+
+CONST_TABLE unsigned char group2_Eb_1_ptr [8] = {
+    0,   0,   0,   0,   0,   0,   1,   0,
+};
+
+CONST_TABLE unsigned long group2_Ev_1_attr [8] = {
+  0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x000200u, 0x300001u,
+};
+
+CONST_TABLE unsigned char group2_Ev_1_ptr [8] = {
+    0,   0,   0,   0,   0,   0,   1,   0,
+};
+
+CONST_TABLE unsigned long group2_Eb_CL_attr [8] = {
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x000200u, 0x100001u,
+};
+
+CONST_TABLE unsigned char group2_Eb_CL_ptr [8] = {
+    0,   0,   0,   0,   0,   0,   1,   0,
+};
+
+CONST_TABLE unsigned long group2_Ev_CL_attr [8] = {
+  0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x000200u, 0x300001u,
+};
+
+CONST_TABLE unsigned char group2_Ev_CL_ptr [8] = {
+    0,   0,   0,   0,   0,   0,   1,   0,
+};
+
+CONST_TABLE unsigned long group3b_attr [8] = {
+  0x100003u, 0x000200u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+};
+
+CONST_TABLE unsigned char group3b_ptr [8] = {
+    0,   1,   0,   0,   0,   0,   0,   0,
+};
+
+CONST_TABLE unsigned long group3v_attr [8] = {
+  0x300009u, 0x000200u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u,
+};
+
+CONST_TABLE unsigned char group3v_ptr [8] = {
+    0,   1,   0,   0,   0,   0,   0,   0,
+};
+
+CONST_TABLE unsigned long ngroup4_attr [8] = {
+  0x100001u, 0x100001u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u,
+};
+
+CONST_TABLE unsigned char ngroup4_ptr [8] = {
+    0,   0,   1,   1,   1,   1,   1,   1,
+};
+
+CONST_TABLE unsigned long ngroup5_attr [8] = {
+  0x300001u, 0x300001u, 0xb00001u, 0x300001u, 0xb00001u, 0x300001u, 0x300001u, 0x000200u,
+};
+
+CONST_TABLE unsigned char ngroup5_ptr [8] = {
+    0,   0,   2,   0,   3,   0,   0,   1,
+};
+
+CONST_TABLE unsigned long ngroup6_attr [8] = {
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x000200u, 0x000200u,
+};
+
+CONST_TABLE unsigned char ngroup6_ptr [8] = {
+    0,   0,   0,   0,   0,   0,   1,   1,
+};
+
+CONST_TABLE unsigned long ngroup7_attr [8] = {
+  0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x000200u, 0x100001u, 0x100001u,
+};
+
+CONST_TABLE unsigned char ngroup7_ptr [8] = {
+    0,   0,   0,   0,   0,   1,   0,   0,
+};
+
+CONST_TABLE unsigned long group8_Ev_Ib_attr [8] = {
+  0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x300003u, 0x300003u, 0x300003u, 0x300003u,
+};
+
+CONST_TABLE unsigned char group8_Ev_Ib_ptr [8] = {
+    1,   1,   1,   1,   0,   0,   0,   0,
+};
+
+CONST_TABLE unsigned long ngroup9_attr [8] = {
+  0x000200u, 0x100001u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u,
+};
+
+CONST_TABLE unsigned char ngroup9_ptr [8] = {
+    1,   0,   1,   1,   1,   1,   1,   1,
+};
+
+CONST_TABLE unsigned long twoByteOpcodes_attr [256] = {
+  0x000800u, 0x000800u, 0x300001u, 0x300001u, 0x000200u, 0x000200u, 0x000000u, 0x000200u,
+  0x000000u, 0x000000u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x100001u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u,
+  0x000001u, 0x000001u, 0x000001u, 0x000001u, 0x000001u, 0x000200u, 0x000001u, 0x000200u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x000000u, 0x000000u, 0x000000u, 0x000000u, 0x000000u, 0x000000u, 0x000200u, 0x000200u,
+  0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000001u, 0x000200u, 0x000200u, 0x000200u,
+  0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u,
+  0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x100003u, 0x100003u, 0x100003u, 0x100003u, 0x100001u, 0x100001u, 0x100001u, 0x100000u,
+  0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x000200u, 0x100001u, 0x100001u,
+  0xa00010u, 0xa00010u, 0xa00010u, 0xa00010u, 0xa00010u, 0xa00010u, 0xa00010u, 0xa00010u,
+  0xa00010u, 0xa00010u, 0xa00010u, 0xa00010u, 0xa00010u, 0xa00010u, 0xa00010u, 0xa00010u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x200000u, 0x200000u, 0x000000u, 0x300001u, 0x300003u, 0x300001u, 0x000200u, 0x000200u,
+  0x200000u, 0x200000u, 0x000000u, 0x300001u, 0x300003u, 0x300001u, 0x100001u, 0x300001u,
+  0x100001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x100001u,
+  0x000200u, 0x000200u, 0x000800u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x100001u,
+  0x100001u, 0x300001u, 0x100003u, 0x100001u, 0x100003u, 0x100003u, 0x100003u, 0x000800u,
+  0x000000u, 0x000000u, 0x000000u, 0x000000u, 0x000000u, 0x000000u, 0x000000u, 0x000000u,
+  0x000200u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x000200u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u,
+  0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x100001u, 0x000200u,
+};
+
+CONST_TABLE unsigned char twoByteOpcodes_ptr [256] = {
+    4,   5,   0,   0,   1,   1,   0,   1,   0,   0,   1,   1,   1,   1,   1,   1,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   1,
+    0,   0,   0,   0,   0,   1,   0,   1,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   6,   0,   1,   1,   1,   1,   1,   1,   0,   1,   1,   1,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   0,   0,
+    7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   1,   1,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   8,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   9,   0,   0,   0,   0,   0,   0,   0,   0,
+    1,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    1,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+};
+
+CONST_TABLE unsigned long nopbyte0_attr [256] = {
+  0x100001u, 0x300001u, 0x100001u, 0x300001u, 0x000002u, 0x200008u, 0x200000u, 0x200000u,
+  0x100001u, 0x300001u, 0x100001u, 0x300001u, 0x000002u, 0x200008u, 0x200000u, 0x000400u,
+  0x100001u, 0x300001u, 0x100001u, 0x300001u, 0x000002u, 0x200008u, 0x200000u, 0x200000u,
+  0x100001u, 0x300001u, 0x100001u, 0x300001u, 0x000002u, 0x200008u, 0x200000u, 0x200000u,
+  0x100001u, 0x300001u, 0x100001u, 0x300001u, 0x000002u, 0x200008u, 0x000100u, 0x000000u,
+  0x100001u, 0x300001u, 0x100001u, 0x300001u, 0x000002u, 0x200008u, 0x000100u, 0x000000u,
+  0x100001u, 0x300001u, 0x100001u, 0x300001u, 0x000002u, 0x200008u, 0x000100u, 0x000000u,
+  0x100001u, 0x300001u, 0x100001u, 0x300001u, 0x000002u, 0x200008u, 0x000100u, 0x000000u,
+  0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u,
+  0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u,
+  0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u,
+  0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u,
+  0x200000u, 0x200000u, 0x300001u, 0x100001u, 0x000100u, 0x000100u, 0x000100u, 0x000100u,
+  0x200008u, 0x300009u, 0x000002u, 0x300003u, 0x100000u, 0x300000u, 0x100000u, 0x300000u,
+  0xa00002u, 0xa00002u, 0xa00002u, 0xa00002u, 0xa00002u, 0xa00002u, 0xa00002u, 0xa00002u,
+  0xa00002u, 0xa00002u, 0xa00002u, 0xa00002u, 0xa00002u, 0xa00002u, 0xa00002u, 0xa00002u,
+  0x000800u, 0x000800u, 0x000800u, 0x000800u, 0x100001u, 0x300001u, 0x100001u, 0x300001u,
+  0x100001u, 0x300001u, 0x100001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u, 0x300001u,
+  0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u, 0x200000u,
+  0x200000u, 0x200000u, 0x208000u, 0x000000u, 0x200000u, 0x200000u, 0x000000u, 0x000000u,
+  0x100040u, 0x300080u, 0x100040u, 0x300080u, 0x100000u, 0x300000u, 0x100000u, 0x300000u,
+  0x000002u, 0x200008u, 0x100000u, 0x300000u, 0x100000u, 0x300000u, 0x100000u, 0x300000u,
+  0x000002u, 0x000002u, 0x000002u, 0x000002u, 0x000002u, 0x000002u, 0x000002u, 0x000002u,
+  0x200008u, 0x200008u, 0x200008u, 0x200008u, 0x200008u, 0x200008u, 0x200008u, 0x200008u,
+  0x000800u, 0x000800u, 0xa04000u, 0xa00000u, 0x300001u, 0x300001u, 0x100003u, 0x300009u,
+  0x004002u, 0x200000u, 0x204000u, 0x200000u, 0x000000u, 0x000002u, 0x000000u, 0x200000u,
+  0x000800u, 0x000800u, 0x000800u, 0x000800u, 0x000002u, 0x000002u, 0x000200u, 0x100000u,
+  0x010000u, 0x010000u, 0x010000u, 0x010000u, 0x010000u, 0x010000u, 0x010000u, 0x010000u,
+  0xb00002u, 0xb00002u, 0xb00002u, 0xb00002u, 0x000002u, 0x200002u, 0x000002u, 0x200002u,
+  0xa00010u, 0xa00010u, 0x208000u, 0xa00002u, 0x000000u, 0x200000u, 0x000000u, 0x200000u,
+  0x000100u, 0x000200u, 0x000100u, 0x000100u, 0x000000u, 0x000000u, 0x000800u, 0x000800u,
+  0x000000u, 0x000000u, 0x000000u, 0x000000u, 0x000000u, 0x000000u, 0x000800u, 0x000800u,
+};
+
+CONST_TABLE unsigned char nopbyte0_ptr [256] = {
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  10,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,  11,   0,   0,   0,   0,   0,   0,   0,  11,   0,
+    0,   0,   0,   0,   0,   0,  11,   0,   0,   0,   0,   0,   0,   0,  11,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,  11,  11,  11,  11,   0,   0,   0,   0,   0,   0,   0,   0,
+    7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,   7,
+   12,  13,  12,  14,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+   15,  16,  17,  18,   0,   0,   0,   0,   0,   0,   0,   0,   0,  19,   0,   0,
+   20,  21,  22,  23,   0,   0,   1,   0,  24,  25,  26,  27,  28,  29,  30,  31,
+   32,  32,  32,  32,   0,   0,   0,   0,  33,  34,   0,  34,   0,   0,   0,   0,
+   11,   1,  11,  11,   0,   0,  35,  36,   0,   0,   0,   0,   0,   0,  37,  38,
+};
+
+CONST_TABLE void *decode_ptrs [256] = {
+  emit_normal,
+  (reserved),
+  emit_call_near_mem,
+  emit_jmp_near_mem,
+  ngroup6,
+  ngroup7,
+  emit_sysenter,
+  emit_jcond,
+  group8_Ev_Ib,
+  ngroup9,
+  twoByteOpcodes,
+  (prefix),
+  group1_Eb_Ib,
+  group1_Ev_Iv,
+  group1_Ev_Ib,
+  group2a_Eb_Ib,
+  group2a_Ev_Ib,
+  emit_ret_Iw,
+  emit_ret,
+  emit_int,
+  group2_Eb_1,
+  group2_Ev_1,
+  group2_Eb_CL,
+  group2_Ev_CL,
+  float_d8,
+  float_d9,
+  float_da,
+  float_db,
+  float_dc,
+  float_dd,
+  float_de,
+  float_df,
+  emit_other_jcond,
+  emit_call_disp,
+  emit_jmp,
+  group3b,
+  group3v,
+  ngroup4,
+  ngroup5,
+};
+
+CONST_TABLE unsigned long *decode_ptrs_attr [256] = {
+  0,
+  0,
+  0,
+  0,
+  ngroup6_attr,
+  ngroup7_attr,
+  0,
+  0,
+  group8_Ev_Ib_attr,
+  ngroup9_attr,
+  twoByteOpcodes_attr,
+  0,
+  group1_Eb_Ib_attr,
+  group1_Ev_Iv_attr,
+  group1_Ev_Ib_attr,
+  group2a_Eb_Ib_attr,
+  group2a_Ev_Ib_attr,
+  0,
+  0,
+  0,
+  group2_Eb_1_attr,
+  group2_Ev_1_attr,
+  group2_Eb_CL_attr,
+  group2_Ev_CL_attr,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  group3b_attr,
+  group3v_attr,
+  ngroup4_attr,
+  ngroup5_attr,
+};
+
 CONST_TABLE OpCode float_d8 [16] = {
   { 0x0u,  "fadd-sr",  2, 4,  0, 0,  0, 0,  emit_normal,   "emit_normal",  1048577,  0 },
   { 0x1u,  "fmul-sr",  2, 4,  0, 0,  0, 0,  emit_normal,   "emit_normal",  1048577,  0 },
@@ -962,3 +1328,3546 @@ CONST_TABLE OpCode float_df_4 [8] = {
   { 0x6u,  "(reserved)",  0, 0,  0, 0,  0, 0,  (reserved),   "(reserved)",  512,  0 },
   { 0x7u,  "(reserved)",  0, 0,  0, 0,  0, 0,  (reserved),   "(reserved)",  512,  0 },
 };
+
+#include "decode-inline.c"
+
+bool
+do_decode_direct(machine_t *M, decode_t *ds)
+{
+#ifdef SUPERVISOR_MODE
+  /* No instruction fetch fault checks here */
+  return do_decode(M, ds);
+#else
+  CONST_TABLE OpCode *pEntry;
+  CONST_TABLE void *emitfn;
+
+  decode_start(M, ds);
+
+ next_byte:
+  decode_mark_instr(M, ds);
+  READ_IN_NEXT_BYTE();
+  switch (ds->b) {
+    case 0x00u:	/* addB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x00u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x01u:	/* addL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x01u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x02u:	/* addB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x02u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x03u:	/* addL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x03u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x04u:	/* addB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0x04u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0x05u:	/* addL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0x05u];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0x06u:	/* push */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x06u];
+      emitfn = emit_normal;
+      break;
+    case 0x07u:	/* pop */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x07u];
+      emitfn = emit_normal;
+      break;
+    case 0x08u:	/* orB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x08u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x09u:	/* orL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x09u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x0au:	/* orB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x0au];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x0bu:	/* orL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x0bu];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x0cu:	/* orB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0x0cu];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0x0du:	/* orL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0x0du];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0x0eu:	/* push */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x0eu];
+      emitfn = emit_normal;
+      break;
+    case 0x0fu:	/* (table) */
+      READ_IN_NEXT_BYTE();
+      switch (ds->b) {
+        case 0x00u:	/* (group) */
+          ds->attr = 0x800u;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          pEntry = &ngroup6[ds->modrm.parts.reg];
+          ds->attr |= ngroup6_attr[ds->modrm.parts.reg];
+          emitfn = decode_ptrs[ngroup6_ptr[ds->modrm.parts.reg]];
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x01u:	/* (group) */
+          ds->attr = 0x800u;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          pEntry = &ngroup7[ds->modrm.parts.reg];
+          ds->attr |= ngroup7_attr[ds->modrm.parts.reg];
+          emitfn = decode_ptrs[ngroup7_ptr[ds->modrm.parts.reg]];
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x02u:	/* lar */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x02u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x03u:	/* lsl */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x03u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x04u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x04u];
+          emitfn = (reserved);
+          break;
+        case 0x05u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x05u];
+          emitfn = (reserved);
+          break;
+        case 0x06u:	/* clts */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0x06u];
+          emitfn = emit_normal;
+          break;
+        case 0x07u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x07u];
+          emitfn = (reserved);
+          break;
+        case 0x08u:	/* invd */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0x08u];
+          emitfn = emit_normal;
+          break;
+        case 0x09u:	/* wbinvd */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0x09u];
+          emitfn = emit_normal;
+          break;
+        case 0x0au:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x0au];
+          emitfn = (reserved);
+          break;
+        case 0x0bu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x0bu];
+          emitfn = (reserved);
+          break;
+        case 0x0cu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x0cu];
+          emitfn = (reserved);
+          break;
+        case 0x0du:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x0du];
+          emitfn = (reserved);
+          break;
+        case 0x0eu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x0eu];
+          emitfn = (reserved);
+          break;
+        case 0x0fu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x0fu];
+          emitfn = (reserved);
+          break;
+        case 0x10u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x10u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x11u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x11u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x12u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x12u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x13u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x13u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x14u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x14u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x15u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x15u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x16u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x16u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x17u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x17u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x18u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x18u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x19u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x19u];
+          emitfn = (reserved);
+          break;
+        case 0x1au:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x1au];
+          emitfn = (reserved);
+          break;
+        case 0x1bu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x1bu];
+          emitfn = (reserved);
+          break;
+        case 0x1cu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x1cu];
+          emitfn = (reserved);
+          break;
+        case 0x1du:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x1du];
+          emitfn = (reserved);
+          break;
+        case 0x1eu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x1eu];
+          emitfn = (reserved);
+          break;
+        case 0x1fu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x1fu];
+          emitfn = (reserved);
+          break;
+        case 0x20u:	/* mov */
+          ds->attr = 0x1u;
+          pEntry = &twoByteOpcodes[0x20u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x21u:	/* mov */
+          ds->attr = 0x1u;
+          pEntry = &twoByteOpcodes[0x21u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x22u:	/* mov */
+          ds->attr = 0x1u;
+          pEntry = &twoByteOpcodes[0x22u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x23u:	/* mov */
+          ds->attr = 0x1u;
+          pEntry = &twoByteOpcodes[0x23u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x24u:	/* mov */
+          ds->attr = 0x1u;
+          pEntry = &twoByteOpcodes[0x24u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x25u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x25u];
+          emitfn = (reserved);
+          break;
+        case 0x26u:	/* mov */
+          ds->attr = 0x1u;
+          pEntry = &twoByteOpcodes[0x26u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x27u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x27u];
+          emitfn = (reserved);
+          break;
+        case 0x28u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x28u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x29u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x29u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x2au:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x2au];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x2bu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x2bu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x2cu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x2cu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x2du:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x2du];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x2eu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x2eu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x2fu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x2fu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x30u:	/* wrmsr */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0x30u];
+          emitfn = emit_normal;
+          break;
+        case 0x31u:	/* rdtsc */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0x31u];
+          emitfn = emit_normal;
+          break;
+        case 0x32u:	/* rdmsr */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0x32u];
+          emitfn = emit_normal;
+          break;
+        case 0x33u:	/* rdpmc */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0x33u];
+          emitfn = emit_normal;
+          break;
+        case 0x34u:	/* sysenter */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0x34u];
+          emitfn = emit_sysenter;
+          break;
+        case 0x35u:	/* sysexit */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0x35u];
+          emitfn = emit_normal;
+          break;
+        case 0x36u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x36u];
+          emitfn = (reserved);
+          break;
+        case 0x37u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x37u];
+          emitfn = (reserved);
+          break;
+        case 0x38u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x38u];
+          emitfn = (reserved);
+          break;
+        case 0x39u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x39u];
+          emitfn = (reserved);
+          break;
+        case 0x3au:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x3au];
+          emitfn = (reserved);
+          break;
+        case 0x3bu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x3bu];
+          emitfn = (reserved);
+          break;
+        case 0x3cu:	/* movnti */
+          ds->attr = 0x1u;
+          pEntry = &twoByteOpcodes[0x3cu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x3du:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x3du];
+          emitfn = (reserved);
+          break;
+        case 0x3eu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x3eu];
+          emitfn = (reserved);
+          break;
+        case 0x3fu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x3fu];
+          emitfn = (reserved);
+          break;
+        case 0x40u:	/* cmovo */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x40u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x41u:	/* cmovno */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x41u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x42u:	/* cmovnae */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x42u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x43u:	/* cmovae */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x43u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x44u:	/* cmove */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x44u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x45u:	/* cmovne */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x45u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x46u:	/* cmovbe */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x46u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x47u:	/* cmovnbe */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x47u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x48u:	/* cmovs */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x48u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x49u:	/* cmovns */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x49u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x4au:	/* cmovp */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x4au];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x4bu:	/* cmovnp */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x4bu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x4cu:	/* cmovl */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x4cu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x4du:	/* cmovge */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x4du];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x4eu:	/* cmovle */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x4eu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x4fu:	/* cmovg */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0x4fu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x50u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x50u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x51u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x51u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x52u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x52u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x53u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x53u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x54u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x54u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x55u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x55u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x56u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x56u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x57u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x57u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x58u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x58u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x59u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x59u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x5au:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x5au];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x5bu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x5bu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x5cu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x5cu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x5du:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x5du];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x5eu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x5eu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x5fu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x5fu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x60u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x60u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x61u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x61u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x62u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x62u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x63u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x63u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x64u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x64u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x65u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x65u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x66u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x66u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x67u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x67u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x68u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x68u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x69u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x69u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x6au:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x6au];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x6bu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x6bu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x6cu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x6cu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x6du:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x6du];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x6eu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x6eu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x6fu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x6fu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x70u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100003u;
+          pEntry = &twoByteOpcodes[0x70u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          decode_Ib(M, ds);
+          break;
+        case 0x71u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100003u;
+          pEntry = &twoByteOpcodes[0x71u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          decode_Ib(M, ds);
+          break;
+        case 0x72u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100003u;
+          pEntry = &twoByteOpcodes[0x72u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          decode_Ib(M, ds);
+          break;
+        case 0x73u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100003u;
+          pEntry = &twoByteOpcodes[0x73u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          decode_Ib(M, ds);
+          break;
+        case 0x74u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x74u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x75u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x75u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x76u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x76u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x77u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100000u;
+          pEntry = &twoByteOpcodes[0x77u];
+          emitfn = emit_normal;
+          break;
+        case 0x78u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x78u];
+          emitfn = (reserved);
+          break;
+        case 0x79u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x79u];
+          emitfn = (reserved);
+          break;
+        case 0x7au:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x7au];
+          emitfn = (reserved);
+          break;
+        case 0x7bu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x7bu];
+          emitfn = (reserved);
+          break;
+        case 0x7cu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x7cu];
+          emitfn = (reserved);
+          break;
+        case 0x7du:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0x7du];
+          emitfn = (reserved);
+          break;
+        case 0x7eu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x7eu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x7fu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x7fu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x80u:	/* jo */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x80u];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x81u:	/* jno */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x81u];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x82u:	/* jb */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x82u];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x83u:	/* jae */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x83u];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x84u:	/* je */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x84u];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x85u:	/* jne */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x85u];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x86u:	/* jbe */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x86u];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x87u:	/* ja */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x87u];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x88u:	/* js */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x88u];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x89u:	/* jns */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x89u];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x8au:	/* jp */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x8au];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x8bu:	/* jnp */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x8bu];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x8cu:	/* jl */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x8cu];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x8du:	/* jge */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x8du];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x8eu:	/* jle */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x8eu];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x8fu:	/* jg */
+          ds->attr = 0xa00010u;
+          pEntry = &twoByteOpcodes[0x8fu];
+          emitfn = emit_jcond;
+          decode_Jv(M, ds);
+          break;
+        case 0x90u:	/* setoB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x90u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x91u:	/* setnoB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x91u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x92u:	/* setbB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x92u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x93u:	/* setnbB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x93u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x94u:	/* setzB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x94u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x95u:	/* setnzB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x95u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x96u:	/* setbeB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x96u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x97u:	/* setnbeB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x97u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x98u:	/* setsB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x98u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x99u:	/* setnsB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x99u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x9au:	/* setpB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x9au];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x9bu:	/* setnpB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x9bu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x9cu:	/* setlB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x9cu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x9du:	/* setnlB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x9du];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x9eu:	/* setleB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x9eu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0x9fu:	/* setnleB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0x9fu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xa0u:	/* push */
+          ds->attr = 0x200000u;
+          pEntry = &twoByteOpcodes[0xa0u];
+          emitfn = emit_normal;
+          break;
+        case 0xa1u:	/* pop */
+          ds->attr = 0x200000u;
+          pEntry = &twoByteOpcodes[0xa1u];
+          emitfn = emit_normal;
+          break;
+        case 0xa2u:	/* cpuid */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0xa2u];
+          emitfn = emit_normal;
+          break;
+        case 0xa3u:	/* btL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xa3u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xa4u:	/* shldL */
+          ds->attr = 0x300003u;
+          pEntry = &twoByteOpcodes[0xa4u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          decode_Ib(M, ds);
+          break;
+        case 0xa5u:	/* shldL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xa5u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xa6u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0xa6u];
+          emitfn = (reserved);
+          break;
+        case 0xa7u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0xa7u];
+          emitfn = (reserved);
+          break;
+        case 0xa8u:	/* push */
+          ds->attr = 0x200000u;
+          pEntry = &twoByteOpcodes[0xa8u];
+          emitfn = emit_normal;
+          break;
+        case 0xa9u:	/* pop */
+          ds->attr = 0x200000u;
+          pEntry = &twoByteOpcodes[0xa9u];
+          emitfn = emit_normal;
+          break;
+        case 0xaau:	/* rsm */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0xaau];
+          emitfn = emit_normal;
+          break;
+        case 0xabu:	/* btsL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xabu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xacu:	/* shrdL */
+          ds->attr = 0x300003u;
+          pEntry = &twoByteOpcodes[0xacu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          decode_Ib(M, ds);
+          break;
+        case 0xadu:	/* shrdL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xadu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xaeu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xaeu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xafu:	/* imulL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xafu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xb0u:	/* cmpxchgB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xb0u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xb1u:	/* cmpxchgL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xb1u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xb2u:	/* lss */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xb2u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xb3u:	/* btr */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xb3u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xb4u:	/* lfs */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xb4u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xb5u:	/* lgs */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xb5u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xb6u:	/* movzbL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xb6u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xb7u:	/* movzwL */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xb7u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xb8u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0xb8u];
+          emitfn = (reserved);
+          break;
+        case 0xb9u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0xb9u];
+          emitfn = (reserved);
+          break;
+        case 0xbau:	/* (group) */
+          ds->attr = 0x800u;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          pEntry = &group8_Ev_Ib[ds->modrm.parts.reg];
+          ds->attr |= group8_Ev_Ib_attr[ds->modrm.parts.reg];
+          emitfn = decode_ptrs[group8_Ev_Ib_ptr[ds->modrm.parts.reg]];
+          decode_modrm_operand(M, ds);
+          decode_immediates(M, ds);
+          break;
+        case 0xbbu:	/* btcL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xbbu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xbcu:	/* bsfL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xbcu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xbdu:	/* bsrL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xbdu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xbeu:	/* movsxL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xbeu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xbfu:	/* movsxL */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xbfu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xc0u:	/* xaddB */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xc0u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xc1u:	/* xaddL */
+          ds->attr = 0x300001u;
+          pEntry = &twoByteOpcodes[0xc1u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xc2u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100003u;
+          pEntry = &twoByteOpcodes[0xc2u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          decode_Ib(M, ds);
+          break;
+        case 0xc3u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xc3u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xc4u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100003u;
+          pEntry = &twoByteOpcodes[0xc4u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          decode_Ib(M, ds);
+          break;
+        case 0xc5u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100003u;
+          pEntry = &twoByteOpcodes[0xc5u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          decode_Ib(M, ds);
+          break;
+        case 0xc6u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100003u;
+          pEntry = &twoByteOpcodes[0xc6u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          decode_Ib(M, ds);
+          break;
+        case 0xc7u:	/* (group) */
+          ds->attr = 0x800u;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          pEntry = &ngroup9[ds->modrm.parts.reg];
+          ds->attr |= ngroup9_attr[ds->modrm.parts.reg];
+          emitfn = decode_ptrs[ngroup9_ptr[ds->modrm.parts.reg]];
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xc8u:	/* bswap */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0xc8u];
+          emitfn = emit_normal;
+          break;
+        case 0xc9u:	/* bswap */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0xc9u];
+          emitfn = emit_normal;
+          break;
+        case 0xcau:	/* bswap */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0xcau];
+          emitfn = emit_normal;
+          break;
+        case 0xcbu:	/* bswap */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0xcbu];
+          emitfn = emit_normal;
+          break;
+        case 0xccu:	/* bswap */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0xccu];
+          emitfn = emit_normal;
+          break;
+        case 0xcdu:	/* bswap */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0xcdu];
+          emitfn = emit_normal;
+          break;
+        case 0xceu:	/* bswap */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0xceu];
+          emitfn = emit_normal;
+          break;
+        case 0xcfu:	/* bswap */
+          ds->attr = 0x0u;
+          pEntry = &twoByteOpcodes[0xcfu];
+          emitfn = emit_normal;
+          break;
+        case 0xd0u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0xd0u];
+          emitfn = (reserved);
+          break;
+        case 0xd1u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xd1u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xd2u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xd2u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xd3u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xd3u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xd4u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xd4u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xd5u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xd5u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xd6u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xd6u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xd7u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xd7u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xd8u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xd8u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xd9u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xd9u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xdau:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xdau];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xdbu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xdbu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xdcu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xdcu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xddu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xddu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xdeu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xdeu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xdfu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xdfu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xe0u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xe0u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xe1u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xe1u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xe2u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xe2u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xe3u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xe3u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xe4u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xe4u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xe5u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xe5u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xe6u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xe6u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xe7u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xe7u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xe8u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xe8u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xe9u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xe9u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xeau:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xeau];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xebu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xebu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xecu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xecu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xedu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xedu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xeeu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xeeu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xefu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xefu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xf0u:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0xf0u];
+          emitfn = (reserved);
+          break;
+        case 0xf1u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xf1u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xf2u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xf2u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xf3u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xf3u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xf4u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xf4u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xf5u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xf5u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xf6u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xf6u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xf7u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xf7u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xf8u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xf8u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xf9u:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xf9u];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xfau:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xfau];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xfbu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xfbu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xfcu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xfcu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xfdu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xfdu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xfeu:	/* MMX/SSE/SSE2 */
+          ds->attr = 0x100001u;
+          pEntry = &twoByteOpcodes[0xfeu];
+          emitfn = emit_normal;
+          READ_IN_NEXT_BYTE();
+          ds->modrm.byte = ds->b;
+          decode_modrm_operand(M, ds);
+          break;
+        case 0xffu:	/* (reserved) */
+          ds->attr = 0x200u;
+          pEntry = &twoByteOpcodes[0xffu];
+          emitfn = (reserved);
+          break;
+      }
+      break;
+    case 0x10u:	/* adcB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x10u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x11u:	/* adcL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x11u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x12u:	/* adcB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x12u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x13u:	/* adcL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x13u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x14u:	/* adcB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0x14u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0x15u:	/* adcL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0x15u];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0x16u:	/* push */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x16u];
+      emitfn = emit_normal;
+      break;
+    case 0x17u:	/* pop */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x17u];
+      emitfn = emit_normal;
+      break;
+    case 0x18u:	/* sbbB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x18u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x19u:	/* sbbL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x19u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x1au:	/* sbbB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x1au];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x1bu:	/* sbbL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x1bu];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x1cu:	/* sbbB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0x1cu];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0x1du:	/* sbbL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0x1du];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0x1eu:	/* push */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x1eu];
+      emitfn = emit_normal;
+      break;
+    case 0x1fu:	/* pop */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x1fu];
+      emitfn = emit_normal;
+      break;
+    case 0x20u:	/* andB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x20u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x21u:	/* andL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x21u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x22u:	/* andB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x22u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x23u:	/* andL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x23u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x24u:	/* andB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0x24u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0x25u:	/* andL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0x25u];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0x26u:	/* es */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0x27u:	/* daa */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0x27u];
+      emitfn = emit_normal;
+      break;
+    case 0x28u:	/* subB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x28u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x29u:	/* subL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x29u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x2au:	/* subB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x2au];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x2bu:	/* subL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x2bu];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x2cu:	/* subB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0x2cu];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0x2du:	/* subL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0x2du];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0x2eu:	/* cs */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0x2fu:	/* das */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0x2fu];
+      emitfn = emit_normal;
+      break;
+    case 0x30u:	/* xorB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x30u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x31u:	/* xorL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x31u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x32u:	/* xorB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x32u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x33u:	/* xorL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x33u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x34u:	/* xorB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0x34u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0x35u:	/* xorL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0x35u];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0x36u:	/* ss */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0x37u:	/* aaa */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0x37u];
+      emitfn = emit_normal;
+      break;
+    case 0x38u:	/* cmpB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x38u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x39u:	/* cmpL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x39u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x3au:	/* cmpB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x3au];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x3bu:	/* cmpL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x3bu];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x3cu:	/* cmpB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0x3cu];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0x3du:	/* cmpL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0x3du];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0x3eu:	/* ds */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0x3fu:	/* aas */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0x3fu];
+      emitfn = emit_normal;
+      break;
+    case 0x40u:	/* incL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x40u];
+      emitfn = emit_normal;
+      break;
+    case 0x41u:	/* incL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x41u];
+      emitfn = emit_normal;
+      break;
+    case 0x42u:	/* incL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x42u];
+      emitfn = emit_normal;
+      break;
+    case 0x43u:	/* incL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x43u];
+      emitfn = emit_normal;
+      break;
+    case 0x44u:	/* incL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x44u];
+      emitfn = emit_normal;
+      break;
+    case 0x45u:	/* incL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x45u];
+      emitfn = emit_normal;
+      break;
+    case 0x46u:	/* incL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x46u];
+      emitfn = emit_normal;
+      break;
+    case 0x47u:	/* incL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x47u];
+      emitfn = emit_normal;
+      break;
+    case 0x48u:	/* decL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x48u];
+      emitfn = emit_normal;
+      break;
+    case 0x49u:	/* decL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x49u];
+      emitfn = emit_normal;
+      break;
+    case 0x4au:	/* decL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x4au];
+      emitfn = emit_normal;
+      break;
+    case 0x4bu:	/* decL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x4bu];
+      emitfn = emit_normal;
+      break;
+    case 0x4cu:	/* decL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x4cu];
+      emitfn = emit_normal;
+      break;
+    case 0x4du:	/* decL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x4du];
+      emitfn = emit_normal;
+      break;
+    case 0x4eu:	/* decL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x4eu];
+      emitfn = emit_normal;
+      break;
+    case 0x4fu:	/* decL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x4fu];
+      emitfn = emit_normal;
+      break;
+    case 0x50u:	/* pushL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x50u];
+      emitfn = emit_normal;
+      break;
+    case 0x51u:	/* pushL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x51u];
+      emitfn = emit_normal;
+      break;
+    case 0x52u:	/* pushL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x52u];
+      emitfn = emit_normal;
+      break;
+    case 0x53u:	/* pushL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x53u];
+      emitfn = emit_normal;
+      break;
+    case 0x54u:	/* pushL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x54u];
+      emitfn = emit_normal;
+      break;
+    case 0x55u:	/* pushL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x55u];
+      emitfn = emit_normal;
+      break;
+    case 0x56u:	/* pushL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x56u];
+      emitfn = emit_normal;
+      break;
+    case 0x57u:	/* pushL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x57u];
+      emitfn = emit_normal;
+      break;
+    case 0x58u:	/* popL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x58u];
+      emitfn = emit_normal;
+      break;
+    case 0x59u:	/* popL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x59u];
+      emitfn = emit_normal;
+      break;
+    case 0x5au:	/* popL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x5au];
+      emitfn = emit_normal;
+      break;
+    case 0x5bu:	/* popL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x5bu];
+      emitfn = emit_normal;
+      break;
+    case 0x5cu:	/* popL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x5cu];
+      emitfn = emit_normal;
+      break;
+    case 0x5du:	/* popL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x5du];
+      emitfn = emit_normal;
+      break;
+    case 0x5eu:	/* popL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x5eu];
+      emitfn = emit_normal;
+      break;
+    case 0x5fu:	/* popL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x5fu];
+      emitfn = emit_normal;
+      break;
+    case 0x60u:	/* pushaL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x60u];
+      emitfn = emit_normal;
+      break;
+    case 0x61u:	/* popaL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x61u];
+      emitfn = emit_normal;
+      break;
+    case 0x62u:	/* bound */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x62u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x63u:	/* arpl */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x63u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x64u:	/* fs */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0x65u:	/* gs */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0x66u:	/* dataN */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0x67u:	/* addrN */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0x68u:	/* pushL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0x68u];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0x69u:	/* imulL */
+      ds->attr = 0x300009u;
+      pEntry = &nopbyte0[0x69u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      decode_Iv(M, ds);
+      break;
+    case 0x6au:	/* push */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0x6au];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0x6bu:	/* imulL */
+      ds->attr = 0x300003u;
+      pEntry = &nopbyte0[0x6bu];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      decode_Ib(M, ds);
+      break;
+    case 0x6cu:	/* insB */
+      ds->attr = 0x100000u;
+      pEntry = &nopbyte0[0x6cu];
+      emitfn = emit_normal;
+      break;
+    case 0x6du:	/* insL */
+      ds->attr = 0x300000u;
+      pEntry = &nopbyte0[0x6du];
+      emitfn = emit_normal;
+      break;
+    case 0x6eu:	/* outsB */
+      ds->attr = 0x100000u;
+      pEntry = &nopbyte0[0x6eu];
+      emitfn = emit_normal;
+      break;
+    case 0x6fu:	/* outsL */
+      ds->attr = 0x300000u;
+      pEntry = &nopbyte0[0x6fu];
+      emitfn = emit_normal;
+      break;
+    case 0x70u:	/* jo */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x70u];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x71u:	/* jno */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x71u];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x72u:	/* jb */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x72u];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x73u:	/* jae */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x73u];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x74u:	/* je */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x74u];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x75u:	/* jne */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x75u];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x76u:	/* jbe */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x76u];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x77u:	/* ja */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x77u];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x78u:	/* js */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x78u];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x79u:	/* jns */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x79u];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x7au:	/* jp */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x7au];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x7bu:	/* jnp */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x7bu];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x7cu:	/* jl */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x7cu];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x7du:	/* jge */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x7du];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x7eu:	/* jle */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x7eu];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x7fu:	/* jg */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0x7fu];
+      emitfn = emit_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0x80u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group1_Eb_Ib[ds->modrm.parts.reg];
+      ds->attr |= group1_Eb_Ib_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group1_Eb_Ib_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      decode_Ib(M, ds);
+      break;
+    case 0x81u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group1_Ev_Iv[ds->modrm.parts.reg];
+      ds->attr |= group1_Ev_Iv_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group1_Ev_Iv_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      decode_Iv(M, ds);
+      break;
+    case 0x82u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group1_Eb_Ib[ds->modrm.parts.reg];
+      ds->attr |= group1_Eb_Ib_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group1_Eb_Ib_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      decode_Ib(M, ds);
+      break;
+    case 0x83u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group1_Ev_Ib[ds->modrm.parts.reg];
+      ds->attr |= group1_Ev_Ib_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group1_Ev_Ib_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      decode_Ib(M, ds);
+      break;
+    case 0x84u:	/* testB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x84u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x85u:	/* testL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x85u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x86u:	/* xchgB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x86u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x87u:	/* xchgL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x87u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x88u:	/* movB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x88u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x89u:	/* movL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x89u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x8au:	/* movB */
+      ds->attr = 0x100001u;
+      pEntry = &nopbyte0[0x8au];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x8bu:	/* movL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x8bu];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x8cu:	/* movL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x8cu];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x8du:	/* lea */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x8du];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x8eu:	/* movL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x8eu];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x8fu:	/* popL */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0x8fu];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0x90u:	/* nop */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x90u];
+      emitfn = emit_normal;
+      break;
+    case 0x91u:	/* xchgL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x91u];
+      emitfn = emit_normal;
+      break;
+    case 0x92u:	/* xchgL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x92u];
+      emitfn = emit_normal;
+      break;
+    case 0x93u:	/* xchgL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x93u];
+      emitfn = emit_normal;
+      break;
+    case 0x94u:	/* xchgL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x94u];
+      emitfn = emit_normal;
+      break;
+    case 0x95u:	/* xchgL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x95u];
+      emitfn = emit_normal;
+      break;
+    case 0x96u:	/* xchgL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x96u];
+      emitfn = emit_normal;
+      break;
+    case 0x97u:	/* xchgL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x97u];
+      emitfn = emit_normal;
+      break;
+    case 0x98u:	/* cWD */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x98u];
+      emitfn = emit_normal;
+      break;
+    case 0x99u:	/* cDQ */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x99u];
+      emitfn = emit_normal;
+      break;
+    case 0x9au:	/* call */
+      ds->attr = 0x208000u;
+      pEntry = &nopbyte0[0x9au];
+      emitfn = emit_normal;
+      decode_Jv(M, ds);
+      decode_Ap(M, ds);
+      break;
+    case 0x9bu:	/* wait */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0x9bu];
+      emitfn = emit_normal;
+      break;
+    case 0x9cu:	/* pushf */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x9cu];
+      emitfn = emit_normal;
+      break;
+    case 0x9du:	/* popf */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0x9du];
+      emitfn = emit_normal;
+      break;
+    case 0x9eu:	/* sahf */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0x9eu];
+      emitfn = emit_normal;
+      break;
+    case 0x9fu:	/* lahf */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0x9fu];
+      emitfn = emit_normal;
+      break;
+    case 0xa0u:	/* movB */
+      ds->attr = 0x100040u;
+      pEntry = &nopbyte0[0xa0u];
+      emitfn = emit_normal;
+      decode_Ov(M, ds);
+      break;
+    case 0xa1u:	/* movL */
+      ds->attr = 0x300080u;
+      pEntry = &nopbyte0[0xa1u];
+      emitfn = emit_normal;
+      decode_Ov(M, ds);
+      break;
+    case 0xa2u:	/* movB */
+      ds->attr = 0x100040u;
+      pEntry = &nopbyte0[0xa2u];
+      emitfn = emit_normal;
+      decode_Ov(M, ds);
+      break;
+    case 0xa3u:	/* movL */
+      ds->attr = 0x300080u;
+      pEntry = &nopbyte0[0xa3u];
+      emitfn = emit_normal;
+      decode_Ov(M, ds);
+      break;
+    case 0xa4u:	/* movsB */
+      ds->attr = 0x100000u;
+      pEntry = &nopbyte0[0xa4u];
+      emitfn = emit_normal;
+      break;
+    case 0xa5u:	/* movsL */
+      ds->attr = 0x300000u;
+      pEntry = &nopbyte0[0xa5u];
+      emitfn = emit_normal;
+      break;
+    case 0xa6u:	/* cmpsB */
+      ds->attr = 0x100000u;
+      pEntry = &nopbyte0[0xa6u];
+      emitfn = emit_normal;
+      break;
+    case 0xa7u:	/* cmpsL */
+      ds->attr = 0x300000u;
+      pEntry = &nopbyte0[0xa7u];
+      emitfn = emit_normal;
+      break;
+    case 0xa8u:	/* testB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xa8u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xa9u:	/* testL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0xa9u];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0xaau:	/* stosB */
+      ds->attr = 0x100000u;
+      pEntry = &nopbyte0[0xaau];
+      emitfn = emit_normal;
+      break;
+    case 0xabu:	/* stosL */
+      ds->attr = 0x300000u;
+      pEntry = &nopbyte0[0xabu];
+      emitfn = emit_normal;
+      break;
+    case 0xacu:	/* lodsB */
+      ds->attr = 0x100000u;
+      pEntry = &nopbyte0[0xacu];
+      emitfn = emit_normal;
+      break;
+    case 0xadu:	/* lodsL */
+      ds->attr = 0x300000u;
+      pEntry = &nopbyte0[0xadu];
+      emitfn = emit_normal;
+      break;
+    case 0xaeu:	/* scasB */
+      ds->attr = 0x100000u;
+      pEntry = &nopbyte0[0xaeu];
+      emitfn = emit_normal;
+      break;
+    case 0xafu:	/* scasL */
+      ds->attr = 0x300000u;
+      pEntry = &nopbyte0[0xafu];
+      emitfn = emit_normal;
+      break;
+    case 0xb0u:	/* movB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xb0u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xb1u:	/* movB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xb1u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xb2u:	/* movB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xb2u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xb3u:	/* movB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xb3u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xb4u:	/* movB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xb4u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xb5u:	/* movB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xb5u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xb6u:	/* movB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xb6u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xb7u:	/* movB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xb7u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xb8u:	/* movL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0xb8u];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0xb9u:	/* movL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0xb9u];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0xbau:	/* movL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0xbau];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0xbbu:	/* movL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0xbbu];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0xbcu:	/* movL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0xbcu];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0xbdu:	/* movL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0xbdu];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0xbeu:	/* movL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0xbeu];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0xbfu:	/* movL */
+      ds->attr = 0x200008u;
+      pEntry = &nopbyte0[0xbfu];
+      emitfn = emit_normal;
+      decode_Iv(M, ds);
+      break;
+    case 0xc0u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group2a_Eb_Ib[ds->modrm.parts.reg];
+      ds->attr |= group2a_Eb_Ib_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group2a_Eb_Ib_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xc1u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group2a_Ev_Ib[ds->modrm.parts.reg];
+      ds->attr |= group2a_Ev_Ib_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group2a_Ev_Ib_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xc2u:	/* retL */
+      ds->attr = 0xa04000u;
+      pEntry = &nopbyte0[0xc2u];
+      emitfn = emit_ret_Iw;
+      decode_Iw(M, ds);
+      break;
+    case 0xc3u:	/* retL */
+      ds->attr = 0xa00000u;
+      pEntry = &nopbyte0[0xc3u];
+      emitfn = emit_ret;
+      break;
+    case 0xc4u:	/* les */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0xc4u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0xc5u:	/* lds */
+      ds->attr = 0x300001u;
+      pEntry = &nopbyte0[0xc5u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      break;
+    case 0xc6u:	/* movB */
+      ds->attr = 0x100003u;
+      pEntry = &nopbyte0[0xc6u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      decode_Ib(M, ds);
+      break;
+    case 0xc7u:	/* movL */
+      ds->attr = 0x300009u;
+      pEntry = &nopbyte0[0xc7u];
+      emitfn = emit_normal;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      decode_modrm_operand(M, ds);
+      decode_Iv(M, ds);
+      break;
+    case 0xc8u:	/* enter */
+      ds->attr = 0x4002u;
+      pEntry = &nopbyte0[0xc8u];
+      emitfn = emit_normal;
+      decode_Iw(M, ds);
+      decode_Ib(M, ds);
+      break;
+    case 0xc9u:	/* leaveL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0xc9u];
+      emitfn = emit_normal;
+      break;
+    case 0xcau:	/* lret */
+      ds->attr = 0x204000u;
+      pEntry = &nopbyte0[0xcau];
+      emitfn = emit_normal;
+      decode_Iw(M, ds);
+      break;
+    case 0xcbu:	/* lret */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0xcbu];
+      emitfn = emit_normal;
+      break;
+    case 0xccu:	/* int3 */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xccu];
+      emitfn = emit_normal;
+      break;
+    case 0xcdu:	/* int */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xcdu];
+      emitfn = emit_int;
+      decode_Ib(M, ds);
+      break;
+    case 0xceu:	/* into */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xceu];
+      emitfn = emit_normal;
+      break;
+    case 0xcfu:	/* iret */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0xcfu];
+      emitfn = emit_normal;
+      break;
+    case 0xd0u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group2_Eb_1[ds->modrm.parts.reg];
+      ds->attr |= group2_Eb_1_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group2_Eb_1_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      break;
+    case 0xd1u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group2_Ev_1[ds->modrm.parts.reg];
+      ds->attr |= group2_Ev_1_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group2_Ev_1_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      break;
+    case 0xd2u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group2_Eb_CL[ds->modrm.parts.reg];
+      ds->attr |= group2_Eb_CL_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group2_Eb_CL_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      break;
+    case 0xd3u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group2_Ev_CL[ds->modrm.parts.reg];
+      ds->attr |= group2_Ev_CL_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group2_Ev_CL_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      break;
+    case 0xd4u:	/* aam */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xd4u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xd5u:	/* aad */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xd5u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xd6u:	/* (reserved) */
+      ds->attr = 0x200u;
+      pEntry = &nopbyte0[0xd6u];
+      emitfn = (reserved);
+      break;
+    case 0xd7u:	/* xlat */
+      ds->attr = 0x100000u;
+      pEntry = &nopbyte0[0xd7u];
+      emitfn = emit_normal;
+      break;
+    case 0xd8u:	/* (float) */
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      if (ds->modrm.parts.mod == 0x3u) {
+        pEntry = &float_d8[ds->modrm.parts.reg + 8];
+        ds->attr = pEntry->attr;
+        if (ds->attr & DF_ONE_MORE_LEVEL) {
+          pEntry = &((CONST_TABLE OpCode *)pEntry->ptr)[ds->modrm.parts.rm];
+          ds->attr = pEntry->attr;
+        }
+      }
+      else {
+        pEntry = &float_d8[ds->modrm.parts.reg];
+        ds->attr = pEntry->attr;
+      }
+      emitfn = pEntry->ptr;
+      if (ds->attr & (DF_MODRM|DF_GROUP))
+        decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xd9u:	/* (float) */
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      if (ds->modrm.parts.mod == 0x3u) {
+        pEntry = &float_d9[ds->modrm.parts.reg + 8];
+        ds->attr = pEntry->attr;
+        if (ds->attr & DF_ONE_MORE_LEVEL) {
+          pEntry = &((CONST_TABLE OpCode *)pEntry->ptr)[ds->modrm.parts.rm];
+          ds->attr = pEntry->attr;
+        }
+      }
+      else {
+        pEntry = &float_d9[ds->modrm.parts.reg];
+        ds->attr = pEntry->attr;
+      }
+      emitfn = pEntry->ptr;
+      if (ds->attr & (DF_MODRM|DF_GROUP))
+        decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xdau:	/* (float) */
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      if (ds->modrm.parts.mod == 0x3u) {
+        pEntry = &float_da[ds->modrm.parts.reg + 8];
+        ds->attr = pEntry->attr;
+        if (ds->attr & DF_ONE_MORE_LEVEL) {
+          pEntry = &((CONST_TABLE OpCode *)pEntry->ptr)[ds->modrm.parts.rm];
+          ds->attr = pEntry->attr;
+        }
+      }
+      else {
+        pEntry = &float_da[ds->modrm.parts.reg];
+        ds->attr = pEntry->attr;
+      }
+      emitfn = pEntry->ptr;
+      if (ds->attr & (DF_MODRM|DF_GROUP))
+        decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xdbu:	/* (float) */
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      if (ds->modrm.parts.mod == 0x3u) {
+        pEntry = &float_db[ds->modrm.parts.reg + 8];
+        ds->attr = pEntry->attr;
+        if (ds->attr & DF_ONE_MORE_LEVEL) {
+          pEntry = &((CONST_TABLE OpCode *)pEntry->ptr)[ds->modrm.parts.rm];
+          ds->attr = pEntry->attr;
+        }
+      }
+      else {
+        pEntry = &float_db[ds->modrm.parts.reg];
+        ds->attr = pEntry->attr;
+      }
+      emitfn = pEntry->ptr;
+      if (ds->attr & (DF_MODRM|DF_GROUP))
+        decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xdcu:	/* (float) */
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      if (ds->modrm.parts.mod == 0x3u) {
+        pEntry = &float_dc[ds->modrm.parts.reg + 8];
+        ds->attr = pEntry->attr;
+        if (ds->attr & DF_ONE_MORE_LEVEL) {
+          pEntry = &((CONST_TABLE OpCode *)pEntry->ptr)[ds->modrm.parts.rm];
+          ds->attr = pEntry->attr;
+        }
+      }
+      else {
+        pEntry = &float_dc[ds->modrm.parts.reg];
+        ds->attr = pEntry->attr;
+      }
+      emitfn = pEntry->ptr;
+      if (ds->attr & (DF_MODRM|DF_GROUP))
+        decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xddu:	/* (float) */
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      if (ds->modrm.parts.mod == 0x3u) {
+        pEntry = &float_dd[ds->modrm.parts.reg + 8];
+        ds->attr = pEntry->attr;
+        if (ds->attr & DF_ONE_MORE_LEVEL) {
+          pEntry = &((CONST_TABLE OpCode *)pEntry->ptr)[ds->modrm.parts.rm];
+          ds->attr = pEntry->attr;
+        }
+      }
+      else {
+        pEntry = &float_dd[ds->modrm.parts.reg];
+        ds->attr = pEntry->attr;
+      }
+      emitfn = pEntry->ptr;
+      if (ds->attr & (DF_MODRM|DF_GROUP))
+        decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xdeu:	/* (float) */
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      if (ds->modrm.parts.mod == 0x3u) {
+        pEntry = &float_de[ds->modrm.parts.reg + 8];
+        ds->attr = pEntry->attr;
+        if (ds->attr & DF_ONE_MORE_LEVEL) {
+          pEntry = &((CONST_TABLE OpCode *)pEntry->ptr)[ds->modrm.parts.rm];
+          ds->attr = pEntry->attr;
+        }
+      }
+      else {
+        pEntry = &float_de[ds->modrm.parts.reg];
+        ds->attr = pEntry->attr;
+      }
+      emitfn = pEntry->ptr;
+      if (ds->attr & (DF_MODRM|DF_GROUP))
+        decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xdfu:	/* (float) */
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      if (ds->modrm.parts.mod == 0x3u) {
+        pEntry = &float_df[ds->modrm.parts.reg + 8];
+        ds->attr = pEntry->attr;
+        if (ds->attr & DF_ONE_MORE_LEVEL) {
+          pEntry = &((CONST_TABLE OpCode *)pEntry->ptr)[ds->modrm.parts.rm];
+          ds->attr = pEntry->attr;
+        }
+      }
+      else {
+        pEntry = &float_df[ds->modrm.parts.reg];
+        ds->attr = pEntry->attr;
+      }
+      emitfn = pEntry->ptr;
+      if (ds->attr & (DF_MODRM|DF_GROUP))
+        decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xe0u:	/* loopne */
+      ds->attr = 0xb00002u;
+      pEntry = &nopbyte0[0xe0u];
+      emitfn = emit_other_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0xe1u:	/* loope */
+      ds->attr = 0xb00002u;
+      pEntry = &nopbyte0[0xe1u];
+      emitfn = emit_other_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0xe2u:	/* loop */
+      ds->attr = 0xb00002u;
+      pEntry = &nopbyte0[0xe2u];
+      emitfn = emit_other_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0xe3u:	/* jcxz */
+      ds->attr = 0xb00002u;
+      pEntry = &nopbyte0[0xe3u];
+      emitfn = emit_other_jcond;
+      decode_Ib(M, ds);
+      break;
+    case 0xe4u:	/* inB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xe4u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xe5u:	/* inL */
+      ds->attr = 0x200002u;
+      pEntry = &nopbyte0[0xe5u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xe6u:	/* outB */
+      ds->attr = 0x2u;
+      pEntry = &nopbyte0[0xe6u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xe7u:	/* outL */
+      ds->attr = 0x200002u;
+      pEntry = &nopbyte0[0xe7u];
+      emitfn = emit_normal;
+      decode_Ib(M, ds);
+      break;
+    case 0xe8u:	/* callL */
+      ds->attr = 0xa00010u;
+      pEntry = &nopbyte0[0xe8u];
+      emitfn = emit_call_disp;
+      decode_Jv(M, ds);
+      break;
+    case 0xe9u:	/* jmpL */
+      ds->attr = 0xa00010u;
+      pEntry = &nopbyte0[0xe9u];
+      emitfn = emit_jmp;
+      decode_Jv(M, ds);
+      break;
+    case 0xeau:	/* ljmp */
+      ds->attr = 0x208000u;
+      pEntry = &nopbyte0[0xeau];
+      emitfn = emit_normal;
+      decode_Jv(M, ds);
+      decode_Ap(M, ds);
+      break;
+    case 0xebu:	/* jmp */
+      ds->attr = 0xa00002u;
+      pEntry = &nopbyte0[0xebu];
+      emitfn = emit_jmp;
+      decode_Ib(M, ds);
+      break;
+    case 0xecu:	/* inB */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xecu];
+      emitfn = emit_normal;
+      break;
+    case 0xedu:	/* inL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0xedu];
+      emitfn = emit_normal;
+      break;
+    case 0xeeu:	/* outB */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xeeu];
+      emitfn = emit_normal;
+      break;
+    case 0xefu:	/* outL */
+      ds->attr = 0x200000u;
+      pEntry = &nopbyte0[0xefu];
+      emitfn = emit_normal;
+      break;
+    case 0xf0u:	/* lock */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0xf1u:	/* (reserved) */
+      ds->attr = 0x200u;
+      pEntry = &nopbyte0[0xf1u];
+      emitfn = (reserved);
+      break;
+    case 0xf2u:	/* repne */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0xf3u:	/* rep */
+      decode_prefix(ds);
+      goto next_byte;
+    case 0xf4u:	/* hlt */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xf4u];
+      emitfn = emit_normal;
+      break;
+    case 0xf5u:	/* cmc */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xf5u];
+      emitfn = emit_normal;
+      break;
+    case 0xf6u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group3b[ds->modrm.parts.reg];
+      ds->attr |= group3b_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group3b_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xf7u:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &group3v[ds->modrm.parts.reg];
+      ds->attr |= group3v_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[group3v_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      decode_immediates(M, ds);
+      break;
+    case 0xf8u:	/* clc */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xf8u];
+      emitfn = emit_normal;
+      break;
+    case 0xf9u:	/* stc */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xf9u];
+      emitfn = emit_normal;
+      break;
+    case 0xfau:	/* cli */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xfau];
+      emitfn = emit_normal;
+      break;
+    case 0xfbu:	/* sti */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xfbu];
+      emitfn = emit_normal;
+      break;
+    case 0xfcu:	/* cld */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xfcu];
+      emitfn = emit_normal;
+      break;
+    case 0xfdu:	/* std */
+      ds->attr = 0x0u;
+      pEntry = &nopbyte0[0xfdu];
+      emitfn = emit_normal;
+      break;
+    case 0xfeu:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &ngroup4[ds->modrm.parts.reg];
+      ds->attr |= ngroup4_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[ngroup4_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      break;
+    case 0xffu:	/* (group) */
+      ds->attr = 0x800u;
+      READ_IN_NEXT_BYTE();
+      ds->modrm.byte = ds->b;
+      pEntry = &ngroup5[ds->modrm.parts.reg];
+      ds->attr |= ngroup5_attr[ds->modrm.parts.reg];
+      emitfn = decode_ptrs[ngroup5_ptr[ds->modrm.parts.reg]];
+      decode_modrm_operand(M, ds);
+      break;
+  }
+
+  return decode_finish(M, ds, pEntry, emitfn);
+#endif
+}
@@ -46,6 +46,7 @@ const char const * const* syscall_names;
 #define LOOKUP_TABLE_SIZE	BBCACHE_SIZE /128	/* BB-directory hash table size */
 #define MAX_TRACE_INSTRS 	512                     /* Usually not enforced */
 #define PATCH_ARRAY_LEN         256
+#define IBUF_LEN                64                      /* Instructions decoded ahead of emission */
 #define COLD_PROC_ENTRY		&M->call_hash_table[0]
 #define NOT_YET_TRANSLATED	((unsigned long) &bad_dispatch)
 
@@ -164,6 +165,94 @@ struct patch_entry {
 };
 
 
+#ifdef NOTE_SITES
+#define PP_ARRAY_LEN            1024
+#define PP_TRACE_BBS            256
+
+/* Kinds of sites noted by the emitters (see peephole.c) */
+#define PP_REL32   0x1u   /* e8/e9 rel32 to a fixed address */
+#define PP_ABS32   0x2u   /* imm32 holding an address within the trace */
+#define PP_JMP     0x3u   /* e9 rel32 patch point */
+#define PP_JCC     0x4u   /* [prefix] 0f 8x rel32 patch point */
+#define PP_LEA4    0x5u   /* leal 4(%esp), %esp with a 32-bit displacement */
+#define PP_ALIGN   0x6u   /* Padding in front of a loop head, added by the pass */
+
+/* Noted only for NOTE_ADDR_SITES */
+#define PP_MABS32  0x7u   /* imm32 holding an address within machine_t */
+#define PP_GABS32  0x8u   /* imm32 holding a guest address */
+#define PP_GNEG32  0x9u   /* imm32 holding a guest address, negated */
+
+typedef struct pp_site pp_site;
+struct pp_site {
+  unsigned char *start;   /* First byte of the instruction */
+  unsigned char *at;      /* Its 32-bit field, the last 4 bytes but for a PP_MABS32 */
+  unsigned long kind;
+
+  /* Filled up by the peephole pass */
+  unsigned char *dest;    /* Resolved target of a patch point, or NULL */
+  unsigned long patch;    /* Index in patch_array, or PATCH_ARRAY_LEN */
+  unsigned long len;      /* Length of the instruction after the pass */
+  long shift;             /* No. of bytes removed before this site */
+  unsigned char prefix;   /* Saved prefix and condition of a PP_JCC */
+  unsigned char cond;
+};
+#endif /* NOTE_SITES */
+
+#ifdef RECYCLE_TRACES
+/* Kinds of relocation records of a trace kept by RECYCLE_TRACES,
+   besides PP_REL32 and PP_ABS32 */
+#define RC_PATCH   0x10u  /* Patch point, "to" is its guest target */
+#define RC_BB      0x11u  /* Start of a bb, "to" is its guest address */
+
+typedef struct rc_reloc rc_reloc;
+struct rc_reloc {
+  unsigned long kind;
+  unsigned long offset;	  /* Of the 32-bit field, or of the bb, in the trace */
+  unsigned long to;
+  unsigned long proc_addr;
+};
+
+/* Code and records are kept in rings, and are located by running
+   counts of what has been put in them: a trace has been overwritten
+   once the counts have moved on by more than the size of the ring */
+typedef struct rc_trace rc_trace;
+struct rc_trace {
+  unsigned long seq;	  /* Running count of this trace */
+  unsigned long src_eip;  /* Guest address of the head */
+  unsigned long proc_entry;
+  unsigned long orig;	  /* Where the trace was translated */
+  unsigned long code;	  /* Running count of the first byte of code */
+  unsigned long len;
+  unsigned long relocs;	  /* Running count of the first record */
+  unsigned long nrelocs;
+};
+#endif /* RECYCLE_TRACES */
+
+#ifdef PERSIST_TRACES
+/* Kinds of records of a trace kept by PERSIST_TRACES, besides the
+   PP_ kinds of sites that hold addresses */
+#define PS_PATCH   0x10u  /* Patch point, "to" is its guest target */
+#define PS_BB      0x11u  /* Start of a bb, "to" is its guest address */
+
+typedef struct ps_reloc ps_reloc;
+struct ps_reloc {
+  unsigned long kind;
+  unsigned long offset;	  /* Of the 32-bit field, or of the bb, in the trace */
+  unsigned long to;
+  unsigned long proc_addr;
+};
+
+typedef struct ps_trace ps_trace;
+struct ps_trace {
+  unsigned long src_eip;  /* Guest address of the head */
+  unsigned long proc_entry;
+  unsigned char *start;	  /* In bbCache */
+  unsigned long len;	  /* Up to its patch blocks */
+  unsigned long relocs;	  /* Index of the first record */
+  unsigned long nrelocs;
+};
+#endif /* PERSIST_TRACES */
+
 typedef struct bb_link bb_link;
 struct bb_link {
   unsigned char *prev_BBcache;
@@ -180,6 +269,8 @@ The Dynamic loader has to map the same structure
 as dumped by the static pass.
 */
 
+/* A code segment of the binary the static pass reads, where it is in
+   the file mapped by sgen. M->sec_info is sorted by start */
 typedef struct sec_mem sec_mem;
 struct sec_mem {
   unsigned int id; 
@@ -244,6 +335,34 @@ struct sa_table_s {
 #endif /* SIGNALS */
 
 
+#ifdef PROFILE_XLATE_PHASES
+/* Phases of the translator, as timed by PROFILE_XLATE_PHASES */
+#define XP_LOOKUP  0	/* Looking up / making the head's bb_entry */
+#define XP_DECODE  1	/* decode_run and the passes */
+#define XP_EMIT    2	/* Emitting, up to the end of the trace */
+#define XP_PATCH   3	/* Linking patch points, building patch blocks */
+#define XP_SIEVE   4	/* Adding sieve nodes */
+#define XP_FLUSH   5	/* Wiping the cache */
+#define XP_NPHASES 6
+
+#define XP_MAX_EMITTERS 128
+
+typedef struct xp_emitter xp_emitter;
+struct xp_emitter {
+  const void *emitfn;
+  const char *name;
+  unsigned long count;		/* Instructions */
+  unsigned long long cycles;
+};
+
+typedef struct xp_trace xp_trace;
+struct xp_trace {
+  unsigned long eip;		/* Guest address of the head */
+  unsigned long instrs;
+  unsigned long long cycles;
+};
+#endif /* PROFILE_XLATE_PHASES */
+
 /* Thread-wide persistent Mstate */
 typedef struct pt_state pt_state;
 struct pt_state {
@@ -283,6 +402,37 @@ struct pt_state {
 
   unsigned long hash_nodes_cnt;
   unsigned long max_nodes_trav_cnt;
+
+#ifdef PEEPHOLE_OPT
+  unsigned long pp_bytes_saved;
+  unsigned long pp_jmps_removed;
+  unsigned long pp_jmps_threaded;
+  unsigned long pp_traces_skipped;
+  unsigned long pp_short_branches;
+#endif
+
+#ifdef FOLLOW_CALLS
+  unsigned long s_calls_followed;
+  unsigned long s_followed_instrs;
+#endif
+
+#ifdef DECODE_CACHE
+  unsigned long dcache_hits;
+  unsigned long dcache_misses;
+#endif
+
+#ifdef RECYCLE_TRACES
+  unsigned long rc_saved;
+  unsigned long rc_recycled;
+  unsigned long rc_recycled_bytes;
+#endif
+
+#ifdef TRACE_ALIGN
+  unsigned long align_pad_bytes;
+  unsigned long aligned_traces;
+  unsigned long loop_pad_bytes;
+  unsigned long aligned_loops;
+#endif
 #endif
   
 #ifdef PROFILE_RET_MISS  
@@ -297,7 +447,16 @@ struct pt_state {
 
 #ifdef PROFILE_TRANSLATION
   unsigned long long trans_time;
+  unsigned long long trans_instrs;
+  unsigned long long trans_bytes;
   unsigned long long tot_time;
+#ifdef PROFILE_XLATE_PHASES
+  unsigned long long xp_cycles[XP_NPHASES];
+  unsigned long xp_count[XP_NPHASES];
+  xp_emitter xp_emitters[XP_MAX_EMITTERS]; /* By emitter, in order of first use */
+  unsigned long xp_nemitters;
+  xp_trace xp_slowest[XP_SLOW_TRACES];     /* Slowest first */
+#endif
 #endif
 
 #ifdef USE_STATIC_DUMP
@@ -307,9 +466,89 @@ struct pt_state {
   bool trigger; // Keep the compiler happy
 };
 
+typedef struct machine_s machine_t;
+
+/* Decoded guest instruction, filled up by do_decode and used by the
+   emitters */
+typedef struct decode_s decode_t;
+struct decode_s {
+  unsigned long decode_eip; /* Start of the Guest Instruction */
+
+/*
+#ifdef STATIC_PASS
+This section has temporarily not been ifdefed 
+ON PURPOSE.
+The Dynamic loader has to map the same structure 
+as dumped by the static pass.
+*/
+  unsigned long mem_decode_eip; /* Start of the in-memort COPY 
+				   of the Guest Instruction */
+/*
+#endif
+*/
+  unsigned char *instr;	 /* Pointer to the instruction AFTER ALL the 
+			    Prefix Bytes */
+  unsigned char *pInstr; /* End of Instruction pointer. 
+			    Actually holds the start of next Instruction */			    
+  unsigned attr;
+
+  unsigned char Group1_Prefix;
+  unsigned char Group2_Prefix;
+  unsigned char Group3_Prefix;
+  unsigned char Group4_Prefix;
+  unsigned char no_of_prefixes;
+  unsigned flags;
+
+  const bool (*emitfn)(machine_t *M, decode_t *ds);
+  const void *pEntry;		/* for disassembly */
+
+  unsigned long b;
+  unsigned opstate;
+
+  /* Saved pieces of the opcode, where applicable: */
+  /* The modrm byte: */
+  modrm_union modrm;
+
+  /* Decode of the SIB byte: */
+  unsigned char need_sib;
+  sib_union sib;
+
+  unsigned dispBytes;		/* displacement length */
+  long displacement;		/* SIGNED displacement */
+
+  /* Registers implicated by the modrm and sib bytes */
+  unsigned long modrm_regs;
+
+  long immediate;		/* SIGNED immediate */
+  long imm16;			/* used in ENTER, RET */
+
+};
+
+#ifdef DECODE_CACHE
+/* Of an instruction, what the emitters that the decode cache is kept
+   for look at (see dcache.c) */
+typedef struct dcache_rec {
+  unsigned short off;		/* Offset in the page, plus 1; 0 if unused */
+  unsigned char len;
+  unsigned char nprefix;	/* Prefix bytes, before ds->instr */
+  unsigned char kind;		/* Emitter, an index into dcache_emitfns */
+  unsigned char flags;
+  unsigned char Group2_Prefix;
+  unsigned char opstate;
+  long immediate;		/* ds->imm16, for emit_ret_Iw */
+  const void *pEntry;
+} dcache_rec;
+
+typedef struct dcache_page {
+  unsigned long page;		/* Guest address of the page, 0 if unused */
+  unsigned long sum;		/* dcache_hash of the page when its records were made */
+  unsigned long epoch;		/* M->dcache_epoch when sum was last checked */
+  dcache_rec rec[DCACHE_PAGE_RECS]; /* Open hash on off */
+} dcache_page;
+#endif /* DECODE_CACHE */
+
 /* Virtual Machine State + Emulator's state required for hosting 
    this guest VM */
-typedef struct machine_s machine_t;
 struct machine_s {
   /* This field should be the first one, as UserEntry.s depends on the same. */
   unsigned char *startup_slow_dispatch_bb;
@@ -340,10 +579,17 @@ struct machine_s {
   patch_entry patch_array[PATCH_ARRAY_LEN]; /* Patch array that will be filled up by all the
 					     emit_jCC's, etc. and used later here for either patching 
 					     them right away or for building patch blocks*/
+  decode_t ibuf[IBUF_LEN];	/* The run of instructions being translated */
 
   unsigned char *bbOut;	        /* next output position in BB Code cache 	*/
   unsigned char *bbCache_main;  /* The point beyond which the actual bb's get emitted */
   const unsigned char *bbLimit; /* BB cache limit 					*/
+#ifdef SHARED_DUMP_CODE
+  unsigned char *shared_lo;	/* Code of a reloaded dump that is mapped shared */
+  unsigned char *shared_hi;	/* (and read-only), so is never written to */
+  unsigned char shared_stubs[SHARED_STUBS_MAX][SHARED_STUB_LEN]; /* Exits from it */
+  unsigned long shared_nstubs;
+#endif
 
   unsigned char *hash_table;   /* Code hash table to perform indirect jumps */
   unsigned char *chash_table;   /* Code hash table to perform indirect calls */
@@ -369,6 +615,50 @@ struct machine_s {
   unsigned char *patch_point;
   bb_entry *curr_bb_entry;
 
+#ifdef DECODE_CACHE
+  dcache_page dcache[DCACHE_PAGES]; /* Survives bb_cache_reinit */
+  unsigned long dcache_epoch;	    /* Flushes so far */
+#endif
+
+#ifdef RECYCLE_TRACES
+  /* Recently translated traces, these survive bb_cache_reinit */
+  unsigned char rc_code[RECYCLE_CODE_SIZE];
+  rc_reloc rc_relocs[RECYCLE_RELOCS_MAX];
+  rc_trace rc_traces[RECYCLE_TRACES_MAX];
+  unsigned long rc_index[RECYCLE_TRACES_MAX]; /* seq of the last trace kept, by head eip */
+  unsigned long rc_code_next;
+  unsigned long rc_relocs_next;
+  unsigned long rc_traces_next;
+#endif
+
+#ifdef PERSIST_TRACES
+  /* Traces in bbCache, written out at exit */
+  ps_trace ps_traces[PERSIST_TRACES_MAX];
+  ps_reloc ps_relocs[PERSIST_RELOCS_MAX];
+  unsigned long ps_ntraces;
+  unsigned long ps_nrelocs;
+#endif
+
+#ifdef SPECULATIVE_XLATE
+  patch_entry spec_array[SPEC_XLATE_MAX]; /* Pending targets of the trace last
+					     translated for a patch block */
+  unsigned long spec_count;
+#endif
+
+#ifdef OUTPUT_BB_STAT
+  unsigned long bbstat_log[BBSTAT_LOG_LEN]; /* Trace heads, in the order first run */
+  unsigned long bbstat_count;
+#endif
+
+#ifdef NOTE_SITES
+  pp_site pp_array[PP_ARRAY_LEN];  /* Sites of the current trace, in emission order */
+  unsigned long pp_count;
+  bb_entry *trace_bbs[PP_TRACE_BBS]; /* bb_entries translated in the current trace */
+  unsigned long trace_nbbs;
+  bool pp_active;                  /* Sites are being noted */
+  bool pp_overflow;                /* Too many sites, skip the pass */
+#endif
+
   sigset_t syscall_sigset;
 
   unsigned long nTrInstr; /* No. of instructions in the current trace */
@@ -0,0 +1,505 @@
+/*
+ * Copyright (c) 2005, Johns Hopkins University and The EROS Group, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ *  * Neither the name of the Johns Hopkins University, nor the name
+ *    of The EROS Group, LLC, nor the names of their contributors may
+ *    be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/***********************************************************************
+                  Peephole pass over a finished trace
+************************************************************************/
+
+/* While a trace is being emitted, the emitters note (bb_note_site)
+   every instruction that either refers to a code address or may be
+   rewritten here:
+
+   PP_REL32 - e8/e9 rel32 to a fixed address (dispatch code, stubs)
+   PP_ABS32 - imm32 holding the address of an instruction of the trace
+              (the expected return address stored by the call emitters)
+   PP_JMP   - e9 rel32 patch point (continue_trace, end of trace, call)
+   PP_JCC   - [prefix] 0f 8x rel32 patch point of emit_jcond
+   PP_LEA4  - leal 4(%esp), %esp emitted with a 32-bit displacement
+
+   All other emitted code is position independent. The hand-coded
+   skips of emit_other_jcond, the call emitters and the syscall
+   handler only jump over sites that never change size.
+
+   With PEEPHOLE_SHORT_BRANCHES, resolved patch points also get the
+   EB / 7x rel8 forms when their target is in range. Patch points
+   that are still pending keep their rel32, the backpatcher needs
+   it.
+
+   With LOOP_ALIGN_MAX_PAD, the pass adds PP_ALIGN sites in front of
+   the targets of backward jumps within the trace. They start out
+   with no bytes at all (at == start - 4) and grow into padding. */
+
+#define PP_MAX_HOPS 4
+#define PP_MAX_LOOP_HEADS 32
+
+static inline unsigned long
+pp_orig_len(pp_site *s)
+{
+  return (s->at + 4) - s->start;
+}
+
+/* Length of the rel8 form of a jmp / jcc site: [prefix] opcode rel8 */
+static inline unsigned long
+pp_short_len(pp_site *s)
+{
+  return (s->kind == PP_JMP) ? 2 : (pp_orig_len(s) - 4);
+}
+
+/* Fill up the shift of every site, returns the total bytes saved */
+static long
+pp_compute_shifts(machine_t *M)
+{
+  unsigned long i;
+  long shift;
+  pp_site *s;
+
+  for (i = 0, shift = 0; i < M->pp_count; i++) {
+    s = &M->pp_array[i];
+    s->shift = shift;
+    shift += (long)pp_orig_len(s) - (long)s->len;
+  }
+  return shift;
+}
+
+/* Is p the start of a patch block? */
+static inline bool
+pp_is_patch_block(machine_t *M, unsigned char *p)
+{
+  return ((p[0] == 0xE8u) &&
+	  ((unsigned long)(p + 5) + *((unsigned long *)(p + 1)) ==
+	   (unsigned long)M->backpatch_and_dispatch_bb));
+}
+
+/* Follow jumps to jumps among the translations that precede this
+   trace. A jump to a patch block is not followed, it will be
+   backpatched to the real target once that gets translated. */
+static unsigned char *
+pp_thread_jump(machine_t *M, unsigned char *dest, unsigned char *tstart)
+{
+#ifndef STATIC_PASS
+  /* The static pass patches all jumps in the very end, so there is
+     nothing to follow yet */
+  unsigned char *next;
+  int hops;
+
+  for (hops = 0; hops < PP_MAX_HOPS; hops++) {
+    if ((dest < M->bbCache_main) || (dest >= tstart) || (dest[0] != 0xE9u))
+      break;
+    next = dest + 5 + *((long *)(dest + 1));
+    if ((next < M->bbCache_main) || (next >= tstart) || pp_is_patch_block(M, next))
+      break;
+    dest = next;
+#ifdef PROFILE
+    M->ptState->pp_jmps_threaded++;
+#endif
+  }
+#endif /* STATIC_PASS */
+  return dest;
+}
+
+/* Where does the address a of the trace [tstart, tend] go after
+   compaction? Addresses outside the trace do not move. */
+static unsigned char *
+pp_map(machine_t *M, unsigned char *a, unsigned char *tstart, unsigned char *tend)
+{
+  long lo = 0, hi = (long)M->pp_count - 1, mid, found = -1;
+  pp_site *s;
+
+  if ((a < tstart) || (a > tend))
+    return a;
+
+  /* Last site that ends at or before a */
+  while (lo <= hi) {
+    mid = (lo + hi) / 2;
+    if (M->pp_array[mid].at + 4 <= a) {
+      found = mid;
+      lo = mid + 1;
+    }
+    else
+      hi = mid - 1;
+  }
+  if (found < 0)
+    return a;
+
+  s = &M->pp_array[found];
+  return a - (s->shift + (long)pp_orig_len(s) - (long)s->len);
+}
+
+#ifdef LOOP_ALIGN_MAX_PAD
+/* Add a PP_ALIGN site in front of every target of a backward jump
+   within the trace, sized for the worst case for now */
+static unsigned long
+pp_add_loop_heads(machine_t *M, unsigned char *tstart, unsigned char *tend)
+{
+  unsigned char *heads[PP_MAX_LOOP_HEADS], *h;
+  unsigned long nheads = 0, i, j, k;
+  pp_site *s;
+
+  for (i = 0; i < M->pp_count; i++) {
+    s = &M->pp_array[i];
+    if ((s->dest == NULL) || (s->len == 0) ||
+	(s->dest <= tstart) || (s->dest > s->start))
+      continue;
+
+    /* Keep the heads sorted, without duplicates */
+    for (k = 0; (k < nheads) && (heads[k] < s->dest); k++)
+      ;
+    if (((k < nheads) && (heads[k] == s->dest)) || (nheads == PP_MAX_LOOP_HEADS))
+      continue;
+    for (j = nheads; j > k; j--)
+      heads[j] = heads[j-1];
+    heads[k] = s->dest;
+    nheads++;
+  }
+
+  /* Leave the room reserved for the patch blocks alone */
+  if ((nheads == 0) || (M->pp_count + nheads > PP_ARRAY_LEN) ||
+      ((M->bbLimit - tend) <= (long)(MAX_PATCH_BLOCK_BYTES + nheads * LOOP_ALIGN_MAX_PAD)))
+    return 0;
+
+  /* Merge, from the back */
+  i = M->pp_count;
+  k = nheads;
+  j = M->pp_count + nheads;
+  M->pp_count = j;
+  while (k > 0) {
+    j--;
+    if ((i > 0) && (M->pp_array[i-1].start >= heads[k-1])) {
+      M->pp_array[j] = M->pp_array[--i];
+      continue;
+    }
+
+    h = heads[--k];
+    s = &M->pp_array[j];
+    s->start = h;
+    s->at = h - 4;
+    s->kind = PP_ALIGN;
+    s->dest = NULL;
+    s->patch = PATCH_ARRAY_LEN;
+    s->len = LOOP_ALIGN_MAX_PAD;
+  }
+  return nheads;
+}
+
+/* Now that all else is known, settle the padding of each loop head */
+static void
+pp_size_loop_heads(machine_t *M)
+{
+  unsigned long i, pad;
+  long shift;
+  pp_site *s;
+
+  for (i = 0, shift = 0; i < M->pp_count; i++) {
+    s = &M->pp_array[i];
+    if (s->kind == PP_ALIGN) {
+      pad = (-(unsigned long)(s->start - shift)) & (TRACE_ALIGN - 1);
+      s->len = (pad <= LOOP_ALIGN_MAX_PAD) ? pad : 0;
+#ifdef PROFILE
+      M->ptState->loop_pad_bytes += s->len;
+      if (s->len != 0)
+	M->ptState->aligned_loops++;
+#endif
+    }
+    shift += (long)pp_orig_len(s) - (long)s->len;
+  }
+}
+#endif /* LOOP_ALIGN_MAX_PAD */
+
+/* Move the code between the sites that change size. Pieces that go
+   towards tstart are moved left to right, then the ones that go the
+   other way right to left, so nothing is overwritten before it has
+   been moved */
+static void
+pp_move_code(machine_t *M, unsigned char *tstart, unsigned char *tend, long total)
+{
+  unsigned char *from, *to;
+  long i, shift;
+  pp_site *s;
+
+  for (i = 0, from = tstart; i < (long)M->pp_count; i++) {
+    s = &M->pp_array[i];
+    if (s->len == pp_orig_len(s))
+      continue;
+    if (s->shift > 0)
+      memmove(from - s->shift, from, s->start - from);
+    from = s->at + 4;
+  }
+  if (total > 0)
+    memmove(from - total, from, tend - from);
+
+  for (i = (long)M->pp_count - 1, to = tend, shift = total; i >= 0; i--) {
+    s = &M->pp_array[i];
+    if (s->len == pp_orig_len(s))
+      continue;
+    from = s->at + 4;
+    if (shift < 0)
+      memmove(from - shift, from, to - from);
+    to = s->start;
+    shift = s->shift;
+  }
+}
+
+static void
+peephole_trace(machine_t *M, unsigned char *tstart)
+{
+  unsigned char *tend = M->bbOut;
+  unsigned char *src, *dst, *nat, *target;
+  unsigned long i, j;
+  long shift;
+  bool edited;
+  bb_entry *entry;
+  pp_site *s;
+#ifdef LOOP_ALIGN_MAX_PAD
+  unsigned long nheads;
+#endif
+#ifdef PEEPHOLE_SHORT_BRANCHES
+  bool changed;
+  long disp;
+#endif
+
+  M->pp_active = false;
+
+  /* Sites must not overlap and must lie within the trace */
+  for (i = 0; (i < M->pp_count) && !M->pp_overflow; i++) {
+    s = &M->pp_array[i];
+    if ((s->start < tstart) || (s->at + 4 > tend) ||
+	((i > 0) && (s->start < M->pp_array[i-1].at + 4)))
+      M->pp_overflow = true;
+  }
+
+  if (M->pp_overflow) {
+#ifdef PROFILE
+    M->ptState->pp_traces_skipped++;
+#endif
+    DEBUG(peephole)
+      fprintf(DBG, "Peephole: skipping trace at %lx\n", (unsigned long)tstart);
+    return;
+  }
+
+  /* 1. Decide what becomes of each site. Patch points whose target
+     has already been translated are resolved right here */
+  for (i = 0, j = 0; i < M->pp_count; i++) {
+    s = &M->pp_array[i];
+    s->dest = NULL;
+    s->patch = PATCH_ARRAY_LEN;
+    s->len = pp_orig_len(s);
+
+    if (s->kind == PP_LEA4) {
+      if ((s->start[0] == 0x8du) && (s->start[1] == 0xA4u) && (s->start[2] == 0x24u))
+	s->len = 4;		/* 8d 64 24 04 */
+      continue;
+    }
+
+    if ((s->kind != PP_JMP) && (s->kind != PP_JCC))
+      continue;
+
+    if (s->kind == PP_JCC) {
+      s->prefix = (pp_orig_len(s) == 7) ? s->start[0] : 0;
+      s->cond = s->at[-1] & 0x0fu;
+    }
+
+    /* Both arrays are in emission order */
+    while ((j < M->patch_count) && (M->patch_array[j].at < s->at))
+      j++;
+    if ((j == M->patch_count) || (M->patch_array[j].at != s->at))
+      continue;
+    s->patch = j;
+
+    entry = lookup_bb_eip(M, (unsigned long) M->patch_array[j].to);
+    if ((entry == NULL) || (entry->trans_bb_eip == NOT_YET_TRANSLATED))
+      continue;
+
+    s->dest = pp_thread_jump(M, (unsigned char *)entry->trans_bb_eip, tstart);
+
+    /* Jump to the next instruction */
+    if (s->dest == s->at + 4) {
+      s->len = 0;
+#ifdef PROFILE
+      M->ptState->pp_jmps_removed++;
+#endif
+    }
+  }
+
+#ifdef LOOP_ALIGN_MAX_PAD
+  nheads = pp_add_loop_heads(M, tstart, tend);
+#endif
+
+  /* 2. Bytes removed ahead of each site */
+  shift = pp_compute_shifts(M);
+
+#ifdef PEEPHOLE_SHORT_BRANCHES
+  /* Relaxation. Shrinking a site only brings targets closer, so
+     repeat until no more jumps can be shortened. A jump forward is
+     measured from the end of its long form, which is conservative
+     until the next round */
+  do {
+    changed = false;
+    for (i = 0; i < M->pp_count; i++) {
+      s = &M->pp_array[i];
+      if ((s->dest == NULL) || (s->len != pp_orig_len(s)))
+	continue;
+
+      nat = s->start - s->shift;
+      target = pp_map(M, s->dest, tstart, tend);
+      if (s->dest > s->start)
+	disp = target - (nat + s->len);
+      else
+	disp = target - (nat + pp_short_len(s));
+
+      if ((disp >= -128) && (disp <= 127)) {
+	s->len = pp_short_len(s);
+	changed = true;
+#ifdef PROFILE
+	M->ptState->pp_short_branches++;
+#endif
+      }
+    }
+    shift = pp_compute_shifts(M);
+  } while (changed);
+#endif /* PEEPHOLE_SHORT_BRANCHES */
+
+#ifdef LOOP_ALIGN_MAX_PAD
+  /* The padding was taken at its largest above, so settling it can
+     only bring jump targets closer */
+  if (nheads != 0) {
+    pp_size_loop_heads(M);
+    shift = pp_compute_shifts(M);
+  }
+#endif
+
+  /* 3. Compact the trace and write out the new forms */
+  for (i = 0, edited = false; (i < M->pp_count) && !edited; i++)
+    edited = (M->pp_array[i].len != pp_orig_len(&M->pp_array[i]));
+
+  if (edited) {
+    pp_move_code(M, tstart, tend, shift);
+
+    for (i = 0; i < M->pp_count; i++) {
+      s = &M->pp_array[i];
+      if ((s->len == pp_orig_len(s)) || (s->len == 0))
+	continue;
+
+      dst = s->start - s->shift;
+      switch (s->kind) {
+      case PP_LEA4:
+	dst[0] = 0x8du;
+	dst[1] = 0x64u;		/* 01 100 100 */
+	dst[2] = 0x24u;		/* 00 100 100 */
+	dst[3] = 0x04u;
+	break;
+#ifdef PEEPHOLE_SHORT_BRANCHES
+      case PP_JMP:
+	dst[0] = 0xEBu;		/* jmp rel8, filled up below */
+	break;
+      case PP_JCC:
+	/* Keep the branch hint prefix, 0f 8x becomes 7x */
+	if (s->prefix != 0)
+	  *dst++ = s->prefix;
+	dst[0] = 0x70u | s->cond;
+	break;
+#endif
+#ifdef LOOP_ALIGN_MAX_PAD
+      case PP_ALIGN:
+	src = M->bbOut;
+	M->bbOut = dst;
+	bb_emit_nops(M, s->len);
+	M->bbOut = src;
+	break;
+#endif
+      }
+    }
+    M->bbOut = tend - shift;
+  }
+
+  /* 4. Fix up everything that refers to a code address */
+  for (i = 0; i < M->pp_count; i++) {
+    s = &M->pp_array[i];
+    nat = s->at - s->shift;
+
+    switch (s->kind) {
+    case PP_REL32:
+      target = s->at + 4 + *((long *)nat);
+      target = pp_map(M, target, tstart, tend);
+      *((unsigned long *)nat) = (unsigned long)(target - (nat + 4));
+      break;
+
+    case PP_ABS32:
+      target = pp_map(M, *((unsigned char **)nat), tstart, tend);
+      *((unsigned long *)nat) = (unsigned long) target;
+      break;
+
+    case PP_JMP:
+    case PP_JCC:
+      if (s->dest == NULL)
+	break;
+      target = pp_map(M, s->dest, tstart, tend);
+      if (s->len == pp_orig_len(s))
+	*((unsigned long *)nat) = (unsigned long)(target - (nat + 4));
+#ifdef PEEPHOLE_SHORT_BRANCHES
+      else if (s->len != 0) {
+	nat = s->start - s->shift + s->len;	/* end of the rel8 form */
+	nat[-1] = (unsigned char)(target - nat);
+      }
+#endif
+      /* Resolved, no patch block needed */
+      M->patch_array[s->patch].at = NULL;
+      break;
+    }
+  }
+
+  for (i = 0, j = 0; i < M->patch_count; i++) {
+    if (M->patch_array[i].at == NULL)
+      continue;
+    M->patch_array[j] = M->patch_array[i];
+    M->patch_array[j].at = pp_map(M, M->patch_array[i].at, tstart, tend);
+    j++;
+  }
+  M->patch_count = j;
+
+  for (i = 0; i < M->trace_nbbs; i++) {
+    entry = M->trace_bbs[i];
+    entry->trans_bb_eip = (unsigned long) 
+      pp_map(M, (unsigned char *)entry->trans_bb_eip, tstart, tend);
+    entry->trans_bb_end_eip = (unsigned long) 
+      pp_map(M, (unsigned char *)entry->trans_bb_end_eip, tstart, tend);
+  }
+
+#ifdef PROFILE
+  M->ptState->pp_bytes_saved += shift;
+#endif
+  DEBUG(peephole)
+    fprintf(DBG, "Peephole: trace at %lx, %lu sites, %ld bytes saved\n", 
+	    (unsigned long)tstart, M->pp_count, shift);
+}
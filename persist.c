@@ -0,0 +1,813 @@
+/*
+ * Copyright (c) 2005, Johns Hopkins University and The EROS Group, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ *  * Neither the name of the Johns Hopkins University, nor the name
+ *    of The EROS Group, LLC, nor the names of their contributors may
+ *    be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/***********************************************************************
+            Persistent traces, rebased when they are loaded
+************************************************************************/
+
+/* xlate_bb notes every trace it finishes in M->ps_traces, along with
+   the sites noted by the emitters that hold addresses, its patch
+   points and the bbs that start within it. At exit, the traces still
+   in bbCache are written out by the module their guest code is in, to
+   /tmp/vdebug-traces-<uid>/<module path>-<module id>-traces, with each
+   address built into them recorded as an offset from what it points
+   into:
+
+   - the trace itself (PP_ABS32, jumps within the trace),
+   - M, for fields of M and the dispatch code in front of
+     bbCache_main (PP_MABS32, proc entries, calls to the dispatchers),
+   - a module found by dl_iterate_phdr, by name, for guest addresses
+     (PP_GABS32, PP_GNEG32, bb and patch targets) and for the
+     translator's own code, called by PP_REL32 sites.
+
+   A trace that refers to any other address, such as the code of
+   another trace, is not kept.
+
+   Since a file is named after one module and its id, and not after
+   the program, the traces of a library are shared by every program
+   that maps the same build of it, among the programs of one user: as
+   the code in the files is run, a file is only used if it and its
+   directory belong to the user and no one else can write to them.
+   init_translator looks for the file
+   of each module mapped at startup, puts their traces back at
+   M->bbOut, writing each recorded field afresh from wherever M and the
+   modules are in this run, and then links up their patch points by
+   emit_patch_blocks, once all of them are in. A trace is dropped if it
+   refers into a module that is not loaded at startup (one that is
+   dlopen'ed later, or another program's executable).
+
+   The files only grow: at exit, each program appends a segment (see
+   persist.h) to the file of each module it ran, with the traces that
+   it did not load from there. A trace that is in a file more than
+   once is put back once, from where it comes first; ps-compact merges
+   the segments of a file and drops such copies. Appending takes a
+   lock on the file that loading waits for, so that half a segment is
+   never seen.
+
+   The code copied from the guest is kept as it was translated. That
+   is safe wherever a module can move, as a PIE or a shared library is
+   position independent, and so is an executable that is always
+   loaded at the same place. The file is ignored if the translator has
+   changed since it was written (by dump_xlate_id), and so are the
+   traces of a module whose build-id or code has changed (by
+   dump_module_id). Traces put back by RECYCLE_TRACES are not kept, and
+   only the traces of the thread that calls exit_group are written. */
+
+#if defined(PEEPHOLE_OPT) || defined(PROFILE) || defined(PROFILE_BB_CNT) || \
+    defined(PROFILE_BB_STATS) || defined(USE_STATIC_DUMP)
+#error "PERSIST_TRACES cannot be used with PEEPHOLE_OPT, PROFILE, PROFILE_BB_CNT, PROFILE_BB_STATS or USE_STATIC_DUMP"
+#endif
+
+#include "persist.h"
+
+/* Base of a module of the file that is not loaded in this run */
+#define PS_NOT_LOADED     (~0ul)
+
+/* Where an address may be, for ps_classify */
+#define PS_TRACE          0x1u
+#define PS_M              0x2u
+#define PS_MODULE         0x4u
+
+typedef struct ps_module ps_module;
+struct ps_module {
+  char name[PS_NAME_LEN];
+  unsigned long base;		/* dlpi_addr */
+  unsigned long lo, hi;		/* Span of its loadable segments */
+  unsigned char id[DUMP_ID_LEN];
+};
+
+static ps_module ps_modules[PS_MODULES_MAX];
+static unsigned long ps_nmodules;
+static unsigned long ps_home[PERSIST_TRACES_MAX]; /* Module of each trace */
+static ps_file_reloc ps_buf[PS_TRACE_RELOCS_MAX];
+
+/* Heads of the traces loaded from the files, which are not written
+   again. Kept across cache flushes */
+#define PS_KNOWN_SIZE     (2 * PERSIST_TRACES_MAX)
+#define PS_KNOWN_HASH(x)  ((((x) >> 2) ^ ((x) >> 14)) & (PS_KNOWN_SIZE - 1))
+
+static unsigned long ps_known[PS_KNOWN_SIZE];
+static unsigned long ps_nknown;
+
+static bool
+ps_is_known(unsigned long src)
+{
+  unsigned long i;
+
+  for (i = PS_KNOWN_HASH(src); ps_known[i] != 0; i = (i + 1) & (PS_KNOWN_SIZE - 1))
+    if (ps_known[i] == src)
+      return true;
+  return false;
+}
+
+static void
+ps_add_known(unsigned long src)
+{
+  unsigned long i;
+
+  /* Past half full, a trace is just written again */
+  if (ps_nknown == PS_KNOWN_SIZE / 2)
+    return;
+  for (i = PS_KNOWN_HASH(src); ps_known[i] != 0; i = (i + 1) & (PS_KNOWN_SIZE - 1))
+    if (ps_known[i] == src)
+      return;
+  ps_known[i] = src;
+  ps_nknown++;
+}
+
+static int
+ps_add_module(struct dl_phdr_info *info, size_t size, void *data)
+{
+  ps_module *m;
+  unsigned long i, lo = ~0ul, hi = 0;
+
+  for (i = 0; i < info->dlpi_phnum; i++) {
+    const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+    if (ph->p_type != PT_LOAD)
+      continue;
+    if (info->dlpi_addr + ph->p_vaddr < lo)
+      lo = info->dlpi_addr + ph->p_vaddr;
+    if (info->dlpi_addr + ph->p_vaddr + ph->p_memsz > hi)
+      hi = info->dlpi_addr + ph->p_vaddr + ph->p_memsz;
+  }
+  if ((lo >= hi) || (ps_nmodules == PS_MODULES_MAX))
+    return 0;
+
+  m = &ps_modules[ps_nmodules++];
+  strncpy(m->name, info->dlpi_name ? info->dlpi_name : "", PS_NAME_LEN - 1);
+  m->name[PS_NAME_LEN - 1] = '\0';
+  m->base = info->dlpi_addr;
+  m->lo = lo;
+  m->hi = hi;
+  dump_module_id(info, m->id);
+  return 0;
+}
+
+/* The modules mapped right now: the guest's, the translator's and the
+   vdso. The executable has an empty name */
+static void
+ps_find_modules(void)
+{
+  ps_nmodules = 0;
+  dl_iterate_phdr(ps_add_module, NULL);
+}
+
+/* The file of module m, in arg[PS_FILE_NAME_LEN] */
+#define PS_FILE_NAME_LEN  (PS_NAME_LEN + 2 * DUMP_ID_LEN + 48)
+
+/* The code in a trace file is run, so only files in a directory that
+   is ours alone, and that are ours and writable by no one else, are
+   used */
+static bool
+ps_dir_ok(const char *dir)
+{
+  struct stat st;
+
+  return (lstat(dir, &st) == 0) && S_ISDIR(st.st_mode) &&
+    (st.st_uid == geteuid()) && ((st.st_mode & (S_IRWXG | S_IRWXO)) == 0);
+}
+
+static bool
+ps_file_ok(int fd)
+{
+  struct stat st;
+
+  return (fstat(fd, &st) == 0) && S_ISREG(st.st_mode) &&
+    (st.st_uid == geteuid()) && ((st.st_mode & (S_IWGRP | S_IWOTH)) == 0);
+}
+
+/* The name of the file of module m, in arg, if the directory of this
+   user's files is safe to use */
+static bool
+ps_file_name(unsigned long m, char *arg)
+{
+  char str[PS_NAME_LEN];
+  long i, n, len;
+
+  n = sprintf(arg, PS_DIR "%u", (unsigned)geteuid());
+  if (!ps_dir_ok(arg))
+    return false;
+
+  if (ps_modules[m].name[0] == '\0') {
+    len = readlink("/proc/self/exe", str, sizeof(str) - 1);
+    if (len < 0)
+      len = 0;
+    str[len] = '\0';
+  }
+  else
+    strcpy(str, ps_modules[m].name);
+  for (i = 0; str[i] != '\0'; i++)
+    if (str[i] == '/')
+      str[i] = '_';
+
+  n += sprintf(arg + n, "/%s-", str);
+  for (i = 0; i < DUMP_ID_LEN; i++)
+    n += sprintf(arg + n, "%02x", ps_modules[m].id[i]);
+  strcpy(arg + n, "-traces");
+  return true;
+}
+
+static inline void
+ps_add_reloc(machine_t *M, unsigned long kind, unsigned long offset,
+	     unsigned long to, unsigned long proc_addr)
+{
+  ps_reloc *r = &M->ps_relocs[M->ps_nrelocs++];
+
+  r->kind = kind;
+  r->offset = offset;
+  r->to = to;
+  r->proc_addr = proc_addr;
+}
+
+/* Note the trace [tstart, tend) just translated for head, whose patch
+   blocks have been emitted */
+static void
+ps_note_trace(machine_t *M, bb_entry *head, unsigned char *tstart,
+	      unsigned char *tend)
+{
+  unsigned long relocs = M->ps_nrelocs;
+  unsigned long i;
+  ps_trace *t;
+  pp_site *s;
+  bb_entry *entry;
+
+  M->pp_active = false;
+
+  if (M->pp_overflow || (tend == tstart) ||
+      (head->trans_bb_eip != (unsigned long)tstart) ||
+      (M->ps_ntraces == PERSIST_TRACES_MAX) ||
+      (relocs + M->pp_count + M->patch_count + M->trace_nbbs > PERSIST_RELOCS_MAX))
+    return;
+
+  for (i = 0; i < M->pp_count; i++) {
+    s = &M->pp_array[i];
+    if ((s->start < tstart) || (s->at + 4 > tend))
+      return;
+  }
+
+  for (i = 0; i < M->pp_count; i++) {
+    s = &M->pp_array[i];
+    switch (s->kind) {
+    case PP_REL32:
+    case PP_ABS32:
+    case PP_MABS32:
+    case PP_GABS32:
+    case PP_GNEG32:
+      ps_add_reloc(M, s->kind, s->at - tstart, 0, 0);
+      break;
+    }
+  }
+  for (i = 0; i < M->patch_count; i++)
+    ps_add_reloc(M, PS_PATCH, M->patch_array[i].at - tstart,
+		 (unsigned long)M->patch_array[i].to, M->patch_array[i].proc_addr);
+  for (i = 0; i < M->trace_nbbs; i++) {
+    entry = M->trace_bbs[i];
+    if ((entry->trans_bb_eip >= (unsigned long)tstart) &&
+	(entry->trans_bb_eip < (unsigned long)tend))
+      ps_add_reloc(M, PS_BB, entry->trans_bb_eip - (unsigned long)tstart,
+		   entry->src_bb_eip, entry->proc_entry);
+  }
+
+  t = &M->ps_traces[M->ps_ntraces++];
+  t->src_eip = head->src_bb_eip;
+  t->proc_entry = head->proc_entry;
+  t->start = tstart;
+  t->len = tend - tstart;
+  t->relocs = relocs;
+  t->nrelocs = M->ps_nrelocs - relocs;
+}
+
+/* Express addr, an address used by trace t, relative to one of the
+   places allowed by where */
+static bool
+ps_classify(machine_t *M, ps_trace *t, unsigned long addr, 
+	    unsigned long where, ps_addr *a)
+{
+  unsigned long i;
+
+  if ((where & PS_TRACE) && (addr >= (unsigned long)t->start) &&
+      (addr < (unsigned long)t->start + t->len)) {
+    a->base = PS_IN_TRACE;
+    a->offset = addr - (unsigned long)t->start;
+    return true;
+  }
+
+  if ((addr >= (unsigned long)M) && (addr < (unsigned long)(M + 1))) {
+    /* The code of other traces does not stay where it is */
+    if (!(where & PS_M) ||
+	((addr >= (unsigned long)M->bbCache_main) &&
+	 (addr < (unsigned long)(M->bbCache + BBCACHE_SIZE))))
+      return false;
+    a->base = PS_IN_M;
+    a->offset = addr - (unsigned long)M;
+    return true;
+  }
+
+  if (where & PS_MODULE)
+    for (i = 0; i < ps_nmodules; i++)
+      if ((addr >= ps_modules[i].lo) && (addr <= ps_modules[i].hi)) {
+	a->base = i;
+	a->offset = addr - ps_modules[i].base;
+	return true;
+      }
+
+  return false;
+}
+
+/* Put trace t in the form it has in the file, in *ft and ps_buf,
+   unless it uses an address that cannot be expressed there */
+static bool
+ps_pack_trace(machine_t *M, ps_trace *t, ps_file_trace *ft)
+{
+  ps_file_reloc *fr;
+  ps_reloc *r;
+  unsigned char *at;
+  unsigned long i, addr, where;
+
+  if (!ps_classify(M, t, t->src_eip, PS_MODULE, &ft->src) ||
+      !ps_classify(M, t, t->proc_entry, PS_M, &ft->proc_entry))
+    return false;
+  ft->len = t->len;
+  ft->nrelocs = t->nrelocs;
+
+  for (i = 0; i < t->nrelocs; i++) {
+    r = &M->ps_relocs[t->relocs + i];
+    fr = &ps_buf[i];
+    at = t->start + r->offset;
+    fr->kind = r->kind;
+    fr->offset = r->offset;
+    fr->proc_addr.base = PS_IN_M;
+    fr->proc_addr.offset = 0;
+
+    switch (r->kind) {
+    case PP_REL32:
+      addr = (unsigned long)at + 4 + *((long *)at);
+      where = PS_TRACE | PS_M | PS_MODULE;
+      break;
+    case PP_ABS32:
+      addr = *((unsigned long *)at);
+      where = PS_TRACE;
+      break;
+    case PP_MABS32:
+      addr = *((unsigned long *)at);
+      where = PS_M;
+      break;
+    case PP_GABS32:
+      addr = *((unsigned long *)at);
+      where = PS_MODULE;
+      break;
+    case PP_GNEG32:
+      addr = -*((unsigned long *)at);
+      where = PS_MODULE;
+      break;
+    default:			/* PS_PATCH, PS_BB */
+      addr = r->to;
+      where = PS_MODULE;
+      if (!ps_classify(M, t, r->proc_addr, PS_M, &fr->proc_addr))
+	return false;
+      break;
+    }
+
+    if (!ps_classify(M, t, addr, where, &fr->to))
+      return false;
+  }
+  return true;
+}
+
+/* Is trace i of M one for the file of module m, that is not there
+   already? Leaves it packed if so */
+static bool
+ps_trace_for(machine_t *M, unsigned long i, unsigned long m, ps_file_trace *ft)
+{
+  return (ps_home[i] == m) && !ps_is_known(M->ps_traces[i].src_eip) &&
+    ps_pack_trace(M, &M->ps_traces[i], ft);
+}
+
+/* Append a segment with the new traces of module m, if it has any */
+static void
+ps_write_module(machine_t *M, unsigned long m)
+{
+  char arg[PS_FILE_NAME_LEN];
+  ps_file_trace ft;
+  ps_header h;
+  FILE *f;
+  int fd;
+  unsigned long i;
+
+  h.magic = PS_MAGIC;
+  h.version = PS_VERSION;
+  h.machine_size = sizeof(machine_t);
+  h.cache_main = M->bbCache_main - M->bbCache;
+  dump_xlate_id(h.xlate_id);
+  h.nmodules = ps_nmodules;
+  h.ntraces = 0;
+
+  for (i = 0; i < M->ps_ntraces; i++)
+    if (ps_trace_for(M, i, m, &ft))
+      h.ntraces++;
+  if (h.ntraces == 0)
+    return;
+
+  if (!ps_file_name(m, arg))
+    return;
+  fd = open(arg, O_WRONLY | O_APPEND | O_CREAT | O_NOFOLLOW, S_IRUSR | S_IWUSR);
+  if (fd == -1)
+    return;
+  if (!ps_file_ok(fd) || ((f = fdopen(fd, "a")) == NULL)) {
+    close(fd);
+    return;
+  }
+  flock(fileno(f), LOCK_EX);
+
+  fwrite(&h, sizeof(h), 1, f);
+  for (i = 0; i < ps_nmodules; i++) {
+    fwrite(ps_modules[i].name, PS_NAME_LEN, 1, f);
+    fwrite(ps_modules[i].id, DUMP_ID_LEN, 1, f);
+  }
+
+  for (i = 0; i < M->ps_ntraces; i++)
+    if (ps_trace_for(M, i, m, &ft)) {
+      fwrite(&ft, sizeof(ft), 1, f);
+      fwrite(ps_buf, sizeof(ps_file_reloc), ft.nrelocs, f);
+      fwrite(M->ps_traces[i].start, 1, ft.len, f);
+    }
+
+  fflush(f);
+  flock(fileno(f), LOCK_UN);
+  fclose(f);
+
+  DEBUG(dump) {
+    fprintf(DBG, "Appended %lu traces to %s\n", h.ntraces, arg);
+    fflush(DBG);
+  }
+}
+
+/* Called from exit_stub */
+void
+ps_write_traces(machine_t *M)
+{
+  ps_addr a;
+  unsigned long i;
+
+  if (M->ps_ntraces == 0)
+    return;
+
+  {
+    char dir[PS_FILE_NAME_LEN];
+    sprintf(dir, PS_DIR "%u", (unsigned)geteuid());
+    mkdir(dir, S_IRWXU);
+  }
+  ps_find_modules();
+  for (i = 0; i < M->ps_ntraces; i++)
+    ps_home[i] = ps_classify(M, &M->ps_traces[i], M->ps_traces[i].src_eip, 
+			     PS_MODULE, &a) ? a.base : PS_MODULES_MAX;
+
+  for (i = 0; i < ps_nmodules; i++)
+    ps_write_module(M, i);
+}
+
+/* The address a of the file in this run, with the bases of its
+   modules in base[] */
+static bool
+ps_resolve(machine_t *M, ps_addr *a, unsigned char *tstart, 
+	   unsigned long *base, unsigned long nmodules, unsigned long *addr)
+{
+  if (a->base == PS_IN_TRACE)
+    *addr = (unsigned long)tstart + a->offset;
+  else if (a->base == PS_IN_M)
+    *addr = (unsigned long)M + a->offset;
+  else if ((a->base < nmodules) && (base[a->base] != PS_NOT_LOADED))
+    *addr = base[a->base] + a->offset;
+  else
+    return false;
+  return true;
+}
+
+/* Bytes of f after the current position, of size in all */
+static unsigned long
+ps_left(FILE *f, unsigned long size)
+{
+  long pos = ftell(f);
+
+  return ((pos < 0) || ((unsigned long)pos > size)) ? 0 : size - pos;
+}
+
+/* Does the ps_file_trace header ft fit in what is left of the file,
+   and in the cache? */
+static bool
+ps_trace_fits(ps_file_trace *ft, unsigned long left)
+{
+  return (ft->len > 0) && (ft->len <= BBCACHE_SIZE) &&
+    (ft->nrelocs <= PS_TRACE_RELOCS_MAX) &&
+    (ft->nrelocs * sizeof(ps_file_reloc) <= left) &&
+    (ft->len <= left - ft->nrelocs * sizeof(ps_file_reloc));
+}
+
+/* Is a within what a trace of len bytes can refer to, if it is in the
+   trace or in M? */
+static inline bool
+ps_addr_ok(ps_addr *a, unsigned long len)
+{
+  if (a->base == PS_IN_TRACE)
+    return a->offset <= len;
+  if (a->base == PS_IN_M)
+    return a->offset < sizeof(machine_t);
+  return true;
+}
+
+/* Are the records in ps_buf of a trace, ft, ones that ps_pack_trace
+   could have written? */
+static bool
+ps_records_ok(ps_file_trace *ft)
+{
+  ps_file_reloc *fr;
+  unsigned long i;
+
+  if (!ps_addr_ok(&ft->src, ft->len) || !ps_addr_ok(&ft->proc_entry, ft->len))
+    return false;
+  for (i = 0; i < ft->nrelocs; i++) {
+    fr = &ps_buf[i];
+    switch (fr->kind) {
+    case PP_REL32:
+    case PP_ABS32:
+    case PP_MABS32:
+    case PP_GABS32:
+    case PP_GNEG32:
+    case PS_PATCH:
+      if ((fr->offset > ft->len) || (ft->len - fr->offset < 4))
+	return false;
+      break;
+    case PS_BB:
+      if (fr->offset >= ft->len)
+	return false;
+      break;
+    default:
+      return false;
+    }
+    if (!ps_addr_ok(&fr->to, ft->len) || !ps_addr_ok(&fr->proc_addr, ft->len))
+      return false;
+  }
+  return true;
+}
+
+/* Put the next trace of f (size bytes long) at M->bbOut, if all that
+   it refers to is there. patch_bytes is the room kept for the patch
+   blocks of the traces loaded so far. Returns false once there is no
+   more to load, or the file is found to be corrupt */
+static bool
+ps_load_trace(machine_t *M, FILE *f, unsigned long size, unsigned long *base, 
+	      unsigned long nmodules, unsigned long *patch_bytes)
+{
+  ps_file_trace ft;
+  ps_file_reloc *fr;
+  unsigned char *tstart;
+  unsigned long src, proc_entry, to, proc_addr, npatches = 0, i;
+  bb_entry *head, *entry;
+
+  if ((fread(&ft, sizeof(ft), 1, f) != 1) || !ps_trace_fits(&ft, ps_left(f, size)) ||
+      (fread(ps_buf, sizeof(ps_file_reloc), ft.nrelocs, f) != ft.nrelocs) ||
+      !ps_records_ok(&ft))
+    return false;
+
+#ifdef TRACE_ALIGN
+  bb_align_trace_head(M);
+#endif
+  tstart = M->bbOut;
+
+  for (i = 0; i < ft.nrelocs; i++) {
+    fr = &ps_buf[i];
+    if (!ps_resolve(M, &fr->to, tstart, base, nmodules, &to) ||
+	(((fr->kind == PS_PATCH) || (fr->kind == PS_BB)) &&
+	 !ps_resolve(M, &fr->proc_addr, tstart, base, nmodules, &proc_addr)))
+      return fseek(f, ft.len, SEEK_CUR) == 0;
+    if (fr->kind == PS_PATCH)
+      npatches++;
+  }
+
+  if ((unsigned long)(M->bbLimit - M->bbOut) <= 
+      ft.len + *patch_bytes + npatches * PATCH_BLOCK_LEN + BYTES_NEEDED_AT_THE_END ||
+      (M->no_of_bbs + ft.nrelocs >= MAX_BBS) ||
+      (M->ps_ntraces == PERSIST_TRACES_MAX) ||
+      (M->ps_nrelocs + ft.nrelocs > PERSIST_RELOCS_MAX))
+    return false;
+
+  /* The code has the procedure entry of the head built into it */
+  if (!ps_resolve(M, &ft.src, tstart, base, nmodules, &src) ||
+      !ps_resolve(M, &ft.proc_entry, tstart, base, nmodules, &proc_entry))
+    return fseek(f, ft.len, SEEK_CUR) == 0;
+  head = lookup_bb_eip(M, src);
+  if ((head != NULL) && ((head->trans_bb_eip != NOT_YET_TRANSLATED) ||
+			 (head->proc_entry != proc_entry)))
+    return fseek(f, ft.len, SEEK_CUR) == 0;
+
+  if (fread(tstart, 1, ft.len, f) != ft.len)
+    return false;
+  M->bbOut = tstart + ft.len;
+  *patch_bytes += npatches * PATCH_BLOCK_LEN;
+
+  M->ps_traces[M->ps_ntraces].src_eip = src;
+  M->ps_traces[M->ps_ntraces].proc_entry = proc_entry;
+  M->ps_traces[M->ps_ntraces].start = tstart;
+  M->ps_traces[M->ps_ntraces].len = ft.len;
+  M->ps_traces[M->ps_ntraces].relocs = M->ps_nrelocs;
+  M->ps_traces[M->ps_ntraces].nrelocs = ft.nrelocs;
+  M->ps_ntraces++;
+  ps_add_known(src);
+
+  for (i = 0; i < ft.nrelocs; i++) {
+    unsigned char *at;
+
+    fr = &ps_buf[i];
+    at = tstart + fr->offset;
+    ps_resolve(M, &fr->to, tstart, base, nmodules, &to);
+    proc_addr = 0;
+
+    switch (fr->kind) {
+    case PP_REL32:
+      *((unsigned long *)at) = to - ((unsigned long)at + 4);
+      break;
+
+    case PP_ABS32:
+    case PP_MABS32:
+    case PP_GABS32:
+      *((unsigned long *)at) = to;
+      break;
+
+    case PP_GNEG32:
+      *((unsigned long *)at) = -to;
+      break;
+
+    case PS_PATCH:
+      /* Linked by ps_load_traces */
+      ps_resolve(M, &fr->proc_addr, tstart, base, nmodules, &proc_addr);
+      break;
+
+    case PS_BB:
+      ps_resolve(M, &fr->proc_addr, tstart, base, nmodules, &proc_addr);
+      entry = lookup_bb_eip(M, to);
+      if (entry == NULL)
+	make_bb_entry(M, to, (unsigned long)at, proc_addr);
+      else if (entry->trans_bb_eip == NOT_YET_TRANSLATED)
+	entry->trans_bb_eip = (unsigned long)at;
+      break;
+    }
+
+    ps_add_reloc(M, fr->kind, fr->offset, 
+		 ((fr->kind == PS_PATCH) || (fr->kind == PS_BB)) ? to : 0, proc_addr);
+  }
+
+  return true;
+}
+
+/* Pass over the next trace of f, of size bytes */
+static bool
+ps_skip_trace(FILE *f, unsigned long size)
+{
+  ps_file_trace ft;
+
+  return (fread(&ft, sizeof(ft), 1, f) == 1) && ps_trace_fits(&ft, ps_left(f, size)) &&
+    (fseek(f, ft.nrelocs * sizeof(ps_file_reloc) + ft.len, SEEK_CUR) == 0);
+}
+
+/* Put the traces of file arg at M->bbOut, segment by segment. Their
+   patch points are left to ps_load_traces */
+static void
+ps_load_file(machine_t *M, const char *arg, unsigned long *patch_bytes)
+{
+  char name[PS_NAME_LEN];
+  unsigned char id[DUMP_ID_LEN], xlate_id[DUMP_ID_LEN];
+  unsigned long base[PS_MODULES_MAX];
+  unsigned long first = M->ps_ntraces, nsegs = 0, stale = 0;
+  unsigned long i, j, n;
+  bool more = true, ok;
+  struct stat st;
+  ps_header h;
+  FILE *f;
+
+  f = fopen(arg, "r");
+  if (f == NULL)
+    return;
+  if (!ps_file_ok(fileno(f))) {
+    DEBUG(dump_load)
+      fprintf(DBG, "%s is not ours alone, not loading it\n", arg);
+    fclose(f);
+    return;
+  }
+  flock(fileno(f), LOCK_SH);
+  if (fstat(fileno(f), &st) != 0) {
+    flock(fileno(f), LOCK_UN);
+    fclose(f);
+    return;
+  }
+  dump_xlate_id(xlate_id);
+
+  while (more && (fread(&h, sizeof(h), 1, f) == 1) && (h.magic == PS_MAGIC) &&
+	 (h.version == PS_VERSION) && (h.nmodules <= PS_MODULES_MAX)) {
+    /* A segment from another build of the translator is passed over */
+    ok = (h.machine_size == sizeof(machine_t)) &&
+      (h.cache_main == M->bbCache_main - M->bbCache) &&
+      (memcmp(h.xlate_id, xlate_id, DUMP_ID_LEN) == 0);
+    if (!ok)
+      stale++;
+
+    /* Where the modules named in the segment are in this run, if they
+       are the same as when it was written */
+    for (i = 0; more && (i < h.nmodules); i++) {
+      base[i] = PS_NOT_LOADED;
+      if ((fread(name, PS_NAME_LEN, 1, f) != 1) ||
+	  (fread(id, DUMP_ID_LEN, 1, f) != 1)) {
+	more = false;
+	break;
+      }
+      name[PS_NAME_LEN - 1] = '\0';
+      for (j = 0; j < ps_nmodules; j++)
+	if ((strcmp(name, ps_modules[j].name) == 0) &&
+	    (memcmp(id, ps_modules[j].id, DUMP_ID_LEN) == 0)) {
+	  base[i] = ps_modules[j].base;
+	  break;
+	}
+    }
+
+    for (n = 0; more && (n < h.ntraces); n++)
+      more = ok ? ps_load_trace(M, f, st.st_size, base, h.nmodules, patch_bytes) :
+	ps_skip_trace(f, st.st_size);
+    nsegs++;
+  }
+
+  flock(fileno(f), LOCK_UN);
+  fclose(f);
+
+  DEBUG(dump_load) {
+    fprintf(DBG, "Loaded %lu traces from %lu segments of %s (%lu from another translator)\n", 
+	    M->ps_ntraces - first, nsegs, arg, stale);
+    fflush(DBG);
+  }
+}
+
+/* Called from init_translator, once the entry of program_start has
+   been made */
+static void
+ps_load_traces(machine_t *M)
+{
+  char arg[PS_FILE_NAME_LEN];
+  unsigned long patch_bytes = 0, first = M->ps_ntraces;
+  unsigned long i, j;
+  ps_trace *t;
+  ps_reloc *r;
+
+  ps_find_modules();
+  for (i = 0; i < ps_nmodules; i++)
+    if (ps_file_name(i, arg))
+      ps_load_file(M, arg, &patch_bytes);
+
+  /* Now that all the traces are in, link them up */
+  for (i = first; i < M->ps_ntraces; i++) {
+    t = &M->ps_traces[i];
+    M->patch_count = 0;
+    for (j = 0; j < t->nrelocs; j++) {
+      r = &M->ps_relocs[t->relocs + j];
+      if (r->kind == PS_PATCH)
+	note_patch(M, t->start + r->offset, (unsigned char *)r->to, r->proc_addr);
+    }
+    emit_patch_blocks(M);
+  }
+  M->patch_count = 0;
+
+  DEBUG(dump_load) {
+    fprintf(DBG, "Loaded %lu traces, %lu bytes\n", M->ps_ntraces - first,
+	    (unsigned long)(M->bbOut - M->bbCache_main));
+    fflush(DBG);
+  }
+}
@@ -0,0 +1,98 @@
+#ifndef PERSIST_H
+#define PERSIST_H
+/*
+ * Copyright (c) 2005, Johns Hopkins University and The EROS Group, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ *  * Neither the name of the Johns Hopkins University, nor the name
+ *    of The EROS Group, LLC, nor the names of their contributors may
+ *    be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+/* Format of the PERSIST_TRACES files, shared by persist.c and the
+   ps-compact tool.
+
+   A file is a run of segments, each appended by one program at exit:
+   a ps_header, its modules (each a name of PS_NAME_LEN bytes and then
+   an id of DUMP_ID_LEN), and then for each trace a ps_file_trace, its
+   records and its code. Module indices in a ps_addr are into the
+   table of the segment the trace is in. */
+
+/* Directory of the files of a user, followed by the euid. It has to
+   be the user's and closed to everyone else, as does each file */
+#define PS_DIR            "/tmp/vdebug-traces-"
+
+#define PS_MAGIC          0x54505644u	/* "DVPT" */
+#define PS_VERSION        3
+
+#define PS_MODULES_MAX    256
+#define PS_NAME_LEN       256
+#define PS_TRACE_RELOCS_MAX (PP_ARRAY_LEN + PATCH_ARRAY_LEN + PP_TRACE_BBS)
+
+/* What the offset of a ps_addr is from, other than a module index */
+#define PS_IN_TRACE       0xFFFFFFFFu
+#define PS_IN_M           0xFFFFFFFEu
+
+typedef struct ps_addr ps_addr;
+struct ps_addr {
+  unsigned long base;
+  unsigned long offset;
+};
+
+typedef struct ps_header ps_header;
+struct ps_header {
+  unsigned long magic;
+  unsigned long version;
+  unsigned long machine_size;	/* sizeof(machine_t) */
+  unsigned long cache_main;	/* Offset of bbCache_main in bbCache */
+  unsigned char xlate_id[DUMP_ID_LEN];
+  unsigned long nmodules;
+  unsigned long ntraces;
+};
+
+typedef struct ps_file_trace ps_file_trace;
+struct ps_file_trace {
+  ps_addr src;
+  ps_addr proc_entry;
+  unsigned long len;
+  unsigned long nrelocs;
+};
+
+/* kind and offset as in ps_reloc; "to" is what a site points to, or
+   the guest address of a PS_PATCH / PS_BB */
+typedef struct ps_file_reloc ps_file_reloc;
+struct ps_file_reloc {
+  unsigned long kind;
+  unsigned long offset;
+  ps_addr to;
+  ps_addr proc_addr;
+};
+
+#endif /* PERSIST_H */
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2005, Johns Hopkins University and The EROS Group, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ *  * Neither the name of the Johns Hopkins University, nor the name
+ *    of The EROS Group, LLC, nor the names of their contributors may
+ *    be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "switches.h"
+#include "debug.h"
+#include "machine.h"
+#include "decode.h"
+#include "emit.h"
+#include "util.h"
+#include "persist.h"
+
+/* ps-compact <file>...
+
+   Merges the segments of each PERSIST_TRACES file (see persist.c) into
+   one, with one module table, and puts it in place of the file. Run it
+   while no translated program is running, as a segment appended while
+   it runs is lost. Dropped are:
+
+   - segments from another build of the translator than the last one
+     appended,
+   - traces whose head is in the file already, but for the first,
+     which is the one that would be loaded. */
+
+typedef struct cp_module cp_module;
+struct cp_module {
+  char name[PS_NAME_LEN];
+  unsigned char id[DUMP_ID_LEN];
+};
+
+static cp_module cp_modules[PS_MODULES_MAX];
+static unsigned long cp_nmodules;
+
+/* Heads kept, by module and offset */
+#define CP_HEADS_SIZE     (1ul << 17)
+
+static ps_addr cp_heads[CP_HEADS_SIZE];
+static bool cp_used[CP_HEADS_SIZE];
+
+static unsigned char *
+read_file(const char *name, unsigned long *len)
+{
+  FILE *f = fopen(name, "r");
+  unsigned char *buf;
+
+  if (f == NULL)
+    return NULL;
+  fseek(f, 0, SEEK_END);
+  *len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  buf = malloc(*len + 1);
+  if ((buf == NULL) || (fread(buf, 1, *len, f) != *len)) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(f);
+  return buf;
+}
+
+/* Index of module m in the merged table, or PS_IN_TRACE if it is full */
+static unsigned long
+cp_module_index(const unsigned char *m)
+{
+  unsigned long i;
+
+  for (i = 0; i < cp_nmodules; i++)
+    if ((strncmp(cp_modules[i].name, (const char *)m, PS_NAME_LEN) == 0) &&
+	(memcmp(cp_modules[i].id, m + PS_NAME_LEN, DUMP_ID_LEN) == 0))
+      return i;
+  if (cp_nmodules == PS_MODULES_MAX)
+    return PS_IN_TRACE;
+  memcpy(cp_modules[i].name, m, PS_NAME_LEN);
+  cp_modules[i].name[PS_NAME_LEN - 1] = '\0';
+  memcpy(cp_modules[i].id, m + PS_NAME_LEN, DUMP_ID_LEN);
+  return cp_nmodules++;
+}
+
+/* Make a into an address of the merged table, by map[] */
+static bool
+cp_remap(ps_addr *a, unsigned long *map, unsigned long nmodules)
+{
+  if ((a->base == PS_IN_TRACE) || (a->base == PS_IN_M))
+    return true;
+  if ((a->base >= nmodules) || (map[a->base] == PS_IN_TRACE))
+    return false;
+  a->base = map[a->base];
+  return true;
+}
+
+/* Was no trace with head src kept yet? If so, it is now */
+static bool
+cp_first_head(ps_addr *src)
+{
+  unsigned long i = ((src->base * 0x9e3779b1ul) ^ (src->offset >> 2)) & (CP_HEADS_SIZE - 1);
+
+  while (cp_used[i]) {
+    if ((cp_heads[i].base == src->base) && (cp_heads[i].offset == src->offset))
+      return false;
+    i = (i + 1) & (CP_HEADS_SIZE - 1);
+  }
+  cp_used[i] = true;
+  cp_heads[i] = *src;
+  return true;
+}
+
+/* Walk the segments of buf[0, len). With out == NULL, the last header
+   is left in *last and the segments are counted; otherwise the traces
+   kept are written to out and counted */
+static unsigned long
+cp_walk(unsigned char *buf, unsigned long len, ps_header *last, FILE *out)
+{
+  unsigned long map[PS_MODULES_MAX];
+  unsigned long pos = 0, i, n, kept = 0, size;
+  ps_header *h;
+  ps_file_trace *ft;
+  ps_file_reloc *fr;
+  bool ok;
+
+  while (pos + sizeof(ps_header) <= len) {
+    h = (ps_header *)(buf + pos);
+    if ((h->magic != PS_MAGIC) || (h->version != PS_VERSION) ||
+	(h->nmodules > PS_MODULES_MAX) ||
+	(pos + sizeof(ps_header) + h->nmodules * (PS_NAME_LEN + DUMP_ID_LEN) > len))
+      break;
+    pos += sizeof(ps_header);
+
+    ok = (out == NULL) || 
+      ((h->machine_size == last->machine_size) && (h->cache_main == last->cache_main) &&
+       (memcmp(h->xlate_id, last->xlate_id, DUMP_ID_LEN) == 0));
+    for (i = 0; i < h->nmodules; i++) {
+      if (ok && (out != NULL))
+	map[i] = cp_module_index(buf + pos);
+      pos += PS_NAME_LEN + DUMP_ID_LEN;
+    }
+
+    for (n = 0; n < h->ntraces; n++) {
+      ft = (ps_file_trace *)(buf + pos);
+      if ((pos + sizeof(ps_file_trace) > len) || 
+	  (ft->nrelocs > (len - pos) / sizeof(ps_file_reloc)))
+	return kept;
+      size = sizeof(ps_file_trace) + ft->nrelocs * sizeof(ps_file_reloc) + ft->len;
+      if (size > len - pos)
+	return kept;
+
+      if (ok && (out != NULL)) {
+	bool keep = cp_remap(&ft->src, map, h->nmodules) &&
+	  cp_remap(&ft->proc_entry, map, h->nmodules);
+	fr = (ps_file_reloc *)(ft + 1);
+	for (i = 0; keep && (i < ft->nrelocs); i++)
+	  keep = cp_remap(&fr[i].to, map, h->nmodules) &&
+	    cp_remap(&fr[i].proc_addr, map, h->nmodules);
+	if (keep && cp_first_head(&ft->src)) {
+	  fwrite(ft, 1, size, out);
+	  kept++;
+	}
+      }
+      pos += size;
+    }
+
+    if (out == NULL) {
+      *last = *h;
+      kept++;
+    }
+  }
+  return kept;
+}
+
+/* Write the header h and the merged module table to name, followed by
+   the traces in body */
+static bool
+cp_write(const char *name, ps_header *h, FILE *body)
+{
+  char buf[65536];
+  unsigned long i, n;
+  int fd;
+  FILE *f;
+
+  /* The translator only loads files that no one else can write to */
+  fd = open(name, O_WRONLY | O_CREAT | O_TRUNC | O_EXCL, S_IRUSR | S_IWUSR);
+  if (fd == -1)
+    return false;
+  f = fdopen(fd, "w");
+  if (f == NULL) {
+    close(fd);
+    return false;
+  }
+  fwrite(h, sizeof(*h), 1, f);
+  for (i = 0; i < cp_nmodules; i++) {
+    fwrite(cp_modules[i].name, PS_NAME_LEN, 1, f);
+    fwrite(cp_modules[i].id, DUMP_ID_LEN, 1, f);
+  }
+  rewind(body);
+  while ((n = fread(buf, 1, sizeof(buf), body)) > 0)
+    fwrite(buf, 1, n, f);
+  return fclose(f) == 0;
+}
+
+static bool
+compact(const char *name)
+{
+  char tmp[PATH_MAX];
+  unsigned char *buf;
+  unsigned long len, nsegs;
+  ps_header h;
+  FILE *body;
+  bool ok;
+
+  buf = read_file(name, &len);
+  if (buf == NULL) {
+    fprintf(stderr, "Cannot read %s\n", name);
+    return false;
+  }
+
+  h.magic = 0;
+  nsegs = cp_walk(buf, len, &h, NULL);
+  if (nsegs == 0) {
+    fprintf(stderr, "%s has no segments\n", name);
+    free(buf);
+    return false;
+  }
+
+  /* The module table goes in front of the traces, but is only complete
+     once they have all been gone through */
+  body = tmpfile();
+  if (body == NULL) {
+    free(buf);
+    return false;
+  }
+  cp_nmodules = 0;
+  memset(cp_used, 0, sizeof(cp_used));
+  h.ntraces = cp_walk(buf, len, &h, body);
+  h.nmodules = cp_nmodules;
+  free(buf);
+
+  snprintf(tmp, sizeof(tmp), "%s.%d", name, getpid());
+  ok = cp_write(tmp, &h, body) && (rename(tmp, name) == 0);
+  fclose(body);
+  if (!ok) {
+    fprintf(stderr, "Cannot write %s\n", tmp);
+    unlink(tmp);
+    return false;
+  }
+
+  printf("%s: %lu segments, now %lu traces over %lu modules\n", name, nsegs,
+	 h.ntraces, h.nmodules);
+  return true;
+}
+
+int
+main(int argc, char **argv)
+{
+  int i, fails = 0;
+
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s <traces file>...\n", argv[0]);
+    return 2;
+  }
+  for (i = 1; i < argc; i++)
+    if (!compact(argv[i]))
+      fails++;
+  return fails ? 1 : 0;
+}
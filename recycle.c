@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2005, Johns Hopkins University and The EROS Group, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ *  * Neither the name of the Johns Hopkins University, nor the name
+ *    of The EROS Group, LLC, nor the names of their contributors may
+ *    be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/***********************************************************************
+               Recycling of traces across cache flushes
+************************************************************************/
+
+/* Every trace that xlate_bb finishes is copied into M->rc_code, along
+   with what it takes to move it elsewhere in bbCache: the sites noted
+   by the emitters that refer to code addresses (PP_REL32, PP_ABS32),
+   its patch points and the bbs that start within it. The rings keep
+   the most recently translated traces, which are the ones that were
+   running when the cache last filled up.
+
+   A trace that is asked for again after the cache has been wiped is
+   copied back to M->bbOut. Fixed addresses called or jumped to are
+   adjusted for the move, addresses within the trace are moved along
+   with it, and the patch points are linked up again by
+   emit_patch_blocks, just as for a trace that has been translated.
+   The pending patch points and PP_JMP / PP_JCC sites themselves need
+   no record of their own.
+
+   As with the rest of the cache, nothing checks whether the guest code
+   has changed since the trace was translated. */
+
+#if defined(PEEPHOLE_OPT) || defined(PROFILE_BB_STATS)
+#error "RECYCLE_TRACES cannot be used with PEEPHOLE_OPT or PROFILE_BB_STATS"
+#endif
+
+#define RC_SLOT(n, size) ((n) & ((size) - 1))
+
+/* Copy len bytes between the code ring, starting at running count
+   pos, and p */
+static void
+rc_copy_code(machine_t *M, unsigned long pos, unsigned char *p, 
+	     unsigned long len, bool out)
+{
+  unsigned long at = RC_SLOT(pos, RECYCLE_CODE_SIZE);
+  unsigned long first = RECYCLE_CODE_SIZE - at;
+
+  if (first > len)
+    first = len;
+  if (out) {
+    memcpy(p, M->rc_code + at, first);
+    memcpy(p + first, M->rc_code, len - first);
+  }
+  else {
+    memcpy(M->rc_code + at, p, first);
+    memcpy(M->rc_code, p + first, len - first);
+  }
+}
+
+static inline void
+rc_add_reloc(machine_t *M, unsigned long kind, unsigned long offset,
+	     unsigned long to, unsigned long proc_addr)
+{
+  rc_reloc *r = &M->rc_relocs[RC_SLOT(M->rc_relocs_next, RECYCLE_RELOCS_MAX)];
+
+  r->kind = kind;
+  r->offset = offset;
+  r->to = to;
+  r->proc_addr = proc_addr;
+  M->rc_relocs_next++;
+}
+
+/* Keep the trace [tstart, tend) just translated for head, whose patch
+   blocks have been emitted */
+static void
+rc_save_trace(machine_t *M, bb_entry *head, unsigned char *tstart, 
+	      unsigned char *tend)
+{
+  unsigned long len = tend - tstart;
+  unsigned long relocs = M->rc_relocs_next;
+  unsigned long i, n;
+  rc_trace *t;
+  pp_site *s;
+  bb_entry *entry;
+
+  M->pp_active = false;
+
+  if (M->pp_overflow || (len == 0) || (len > RECYCLE_TRACE_MAX_BYTES) ||
+      (head->trans_bb_eip != (unsigned long)tstart) ||
+      ((M->pp_count + M->patch_count + M->trace_nbbs) > RECYCLE_RELOCS_MAX / 8))
+    return;
+
+  for (i = 0; i < M->pp_count; i++) {
+    s = &M->pp_array[i];
+    if ((s->start < tstart) || (s->at + 4 > tend))
+      return;
+  }
+
+  for (i = 0; i < M->pp_count; i++) {
+    s = &M->pp_array[i];
+    if ((s->kind == PP_REL32) || (s->kind == PP_ABS32))
+      rc_add_reloc(M, s->kind, s->at - tstart, 0, 0);
+  }
+  for (i = 0; i < M->patch_count; i++)
+    rc_add_reloc(M, RC_PATCH, M->patch_array[i].at - tstart,
+		 (unsigned long)M->patch_array[i].to, M->patch_array[i].proc_addr);
+  for (i = 0; i < M->trace_nbbs; i++) {
+    entry = M->trace_bbs[i];
+    if ((entry->trans_bb_eip >= (unsigned long)tstart) &&
+	(entry->trans_bb_eip < (unsigned long)tend))
+      rc_add_reloc(M, RC_BB, entry->trans_bb_eip - (unsigned long)tstart,
+		   entry->src_bb_eip, entry->proc_entry);
+  }
+
+  n = ++M->rc_traces_next;
+  t = &M->rc_traces[RC_SLOT(n, RECYCLE_TRACES_MAX)];
+  t->seq = n;
+  t->src_eip = head->src_bb_eip;
+  t->proc_entry = head->proc_entry;
+  t->orig = (unsigned long)tstart;
+  t->code = M->rc_code_next;
+  t->len = len;
+  t->relocs = relocs;
+  t->nrelocs = M->rc_relocs_next - relocs;
+
+  rc_copy_code(M, t->code, tstart, len, false);
+  M->rc_code_next += len;
+  M->rc_index[RC_SLOT(t->src_eip, RECYCLE_TRACES_MAX)] = n;
+
+#ifdef PROFILE
+  M->ptState->rc_saved++;
+#endif
+}
+
+/* Put back the trace last kept for head at M->bbOut, if it is still
+   there and fits. The caller emits the patch blocks */
+static bool
+rc_recycle_trace(machine_t *M, bb_entry *head)
+{
+  unsigned long n = M->rc_index[RC_SLOT(head->src_bb_eip, RECYCLE_TRACES_MAX)];
+  rc_trace *t = &M->rc_traces[RC_SLOT(n, RECYCLE_TRACES_MAX)];
+  unsigned char *tstart = M->bbOut;
+  unsigned long orig_end, dest, i;
+  long delta;
+  unsigned char *at;
+  rc_reloc *r;
+  bb_entry *entry;
+
+  /* The code has the procedure entry of the head built into it */
+  if ((n == 0) || (t->seq != n) || (t->src_eip != head->src_bb_eip) ||
+      (t->proc_entry != head->proc_entry) ||
+      (M->rc_code_next - t->code > RECYCLE_CODE_SIZE) ||
+      (M->rc_relocs_next - t->relocs > RECYCLE_RELOCS_MAX))
+    return false;
+
+  /* Room for the code, its patch blocks and its bb_entries */
+  if (((M->bbLimit - M->bbOut) <= (long)(t->len + BYTES_NEEDED_AT_THE_END)) ||
+      (M->no_of_bbs + t->nrelocs >= MAX_BBS))
+    return false;
+
+  DEBUG(xlate) {
+    fprintf(DBG, "Recycling trace of %lx, %lu bytes\n", t->src_eip, t->len);
+    fflush(DBG);
+  }
+
+  rc_copy_code(M, t->code, tstart, t->len, true);
+  M->bbOut = tstart + t->len;
+  delta = (long)tstart - (long)t->orig;
+  orig_end = t->orig + t->len;
+
+  M->patch_count = 0;
+  for (i = 0; i < t->nrelocs; i++) {
+    r = &M->rc_relocs[RC_SLOT(t->relocs + i, RECYCLE_RELOCS_MAX)];
+    at = tstart + r->offset;
+
+    switch (r->kind) {
+    case PP_REL32:
+      dest = t->orig + r->offset + 4 + *((long *)at);
+      if ((dest < t->orig) || (dest >= orig_end))
+	*((long *)at) -= delta;
+      break;
+
+    case PP_ABS32:
+      dest = *((unsigned long *)at);
+      if ((dest >= t->orig) && (dest <= orig_end))
+	*((unsigned long *)at) = dest + delta;
+      break;
+
+    case RC_PATCH:
+      M->patch_array[M->patch_count].at = at;
+      M->patch_array[M->patch_count].to = (unsigned char *)r->to;
+      M->patch_array[M->patch_count].proc_addr = r->proc_addr;
+      M->patch_count++;
+      break;
+
+    case RC_BB:
+      /* A bb that has been translated since the wipe keeps that
+	 translation */
+      entry = lookup_bb_eip(M, r->to);
+      if (entry == NULL)
+	make_bb_entry(M, r->to, (unsigned long)at, r->proc_addr);
+      else if (entry->trans_bb_eip == NOT_YET_TRANSLATED)
+	entry->trans_bb_eip = (unsigned long)at;
+      break;
+    }
+  }
+
+  M->curr_bb_entry = head;
+
+#ifdef PROFILE
+  M->ptState->rc_recycled++;
+  M->ptState->rc_recycled_bytes += t->len;
+#endif
+  return true;
+}
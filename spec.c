@@ -0,0 +1,430 @@
+/*
+ * Copyright (c) 2005, Johns Hopkins University and The EROS Group, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ *  * Neither the name of the Johns Hopkins University, nor the name
+ *    of The EROS Group, LLC, nor the names of their contributors may
+ *    be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+/***********************************************************************
+         Speculative translation, on a thread of its own
+************************************************************************/
+
+/* When a patch block is translated, the targets that its trace leaves
+   pending (behind patch blocks of their own) are queued for a helper
+   thread. The helper translates each of them into a machine of its
+   own, S, with the sites noted by the emitters, and copies the code
+   and its records into a slot of the staging area. None of this is on
+   the guest's path: the guest goes on running as soon as its own
+   target is translated.
+
+   The next time the guest enters xlate_for_patch_block, the staged
+   traces are put in M at M->bbOut, rebased from S to M much as
+   RECYCLE_TRACES moves a trace within M: fields of S and calls into
+   its dispatch code are pointed at the same ones of M, the trace's own
+   addresses move with it, and its patch points are linked up by
+   emit_patch_blocks. The jump that the target was queued for is then
+   linked straight to the trace, if it still goes to that patch block.
+
+   A trace is dropped if M has translated its head since, if M has
+   been wiped since and no longer knows the head, or if it refers to
+   the code of another trace of S. Only the first M to queue anything
+   (that of the main thread) is served, and nothing is queued from a
+   child process, which does not have the helper. */
+
+#if defined(PEEPHOLE_OPT) || defined(PROFILE) || defined(PROFILE_BB_CNT) || \
+    defined(PROFILE_BB_STATS) || defined(OUTPUT_BB_STAT)
+#error "SPECULATIVE_XLATE cannot be used with PEEPHOLE_OPT, PROFILE, PROFILE_BB_CNT, PROFILE_BB_STATS or OUTPUT_BB_STAT"
+#endif
+
+/* Kinds of records of a staged trace, besides PP_REL32, PP_ABS32 and
+   PP_MABS32 */
+#define SPEC_PATCH   0x10u  /* Patch point, "to" is its guest target */
+#define SPEC_BB      0x11u  /* Start of a bb, "to" is its guest address */
+
+typedef struct spec_reloc spec_reloc;
+struct spec_reloc {
+  unsigned long kind;
+  unsigned long offset;	  /* Of the 32-bit field, or of the bb, in the trace */
+  unsigned long to;
+  unsigned long proc_addr; /* In S */
+};
+
+typedef struct spec_slot spec_slot;
+struct spec_slot {
+  patch_entry req;	  /* What was queued: at is the jump in M */
+  unsigned long proc_entry; /* Of the head, in S */
+  unsigned long orig;	  /* Where the trace was translated in S */
+  unsigned long len;
+  unsigned long nrelocs;
+  spec_reloc relocs[SPEC_TRACE_RELOCS_MAX];
+  unsigned char code[SPEC_TRACE_MAX_BYTES];
+};
+
+/* The queue and the staging area are rings, indexed by running
+   counts. Entries between the counts of the consumer and of the
+   producer belong to the producer until the count is moved on, under
+   spec_lock */
+static pthread_mutex_t spec_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t spec_wake = PTHREAD_COND_INITIALIZER;
+static patch_entry spec_queue[SPEC_QUEUE_LEN];
+static unsigned long spec_queued, spec_taken;
+static spec_slot spec_stage[SPEC_STAGE_LEN];
+static unsigned long spec_staged, spec_installed;
+
+static machine_t *spec_M;	/* The machine served */
+static machine_t *spec_S;	/* The helper's */
+static pid_t spec_pid;
+static spec_slot *spec_cur;	/* Slot being filled by xlate_bb in S */
+
+#define SPEC_SLOT(n, size) ((n) & ((size) - 1))
+#define SPEC_S_SIZE (sizeof(machine_t) + sizeof(pt_state))
+
+static inline bool
+spec_in_S(unsigned long addr)
+{
+  return (addr >= (unsigned long)spec_S) && 
+    (addr < (unsigned long)spec_S + SPEC_S_SIZE);
+}
+
+static inline unsigned long
+spec_to_M(unsigned long addr)
+{
+  return addr - (unsigned long)spec_S + (unsigned long)spec_M;
+}
+
+/* Called by xlate_bb in S, for the trace [tstart, tend) just translated
+   for head, whose patch blocks have been emitted */
+static void
+spec_stage_trace(machine_t *S, bb_entry *head, unsigned char *tstart,
+		 unsigned char *tend)
+{
+  spec_slot *t = spec_cur;
+  unsigned long len = tend - tstart;
+  unsigned long i, dest;
+  pp_site *s;
+  bb_entry *entry;
+  spec_reloc *r;
+
+  S->pp_active = false;
+  spec_cur = NULL;
+
+  if ((t == NULL) || S->pp_overflow || (len == 0) || 
+      (len > SPEC_TRACE_MAX_BYTES) ||
+      (head->trans_bb_eip != (unsigned long)tstart) ||
+      (S->pp_count + S->patch_count + S->trace_nbbs > SPEC_TRACE_RELOCS_MAX))
+    return;
+
+  t->nrelocs = 0;
+  for (i = 0; i < S->pp_count; i++) {
+    s = &S->pp_array[i];
+    if ((s->start < tstart) || (s->at + 4 > tend))
+      return;
+    switch (s->kind) {
+    case PP_REL32:
+      /* Another trace of S will not be in M */
+      dest = (unsigned long)s->at + 4 + *((long *)s->at);
+      if (spec_in_S(dest) && 
+	  ((dest < (unsigned long)tstart) || (dest >= (unsigned long)tend)) &&
+	  (dest >= (unsigned long)S->bbCache_main) &&
+	  (dest < (unsigned long)(S->bbCache + BBCACHE_SIZE)))
+	return;
+      break;
+    case PP_ABS32:
+    case PP_MABS32:
+      break;
+    default:
+      continue;
+    }
+    r = &t->relocs[t->nrelocs++];
+    r->kind = s->kind;
+    r->offset = s->at - tstart;
+  }
+  for (i = 0; i < S->patch_count; i++) {
+    r = &t->relocs[t->nrelocs++];
+    r->kind = SPEC_PATCH;
+    r->offset = S->patch_array[i].at - tstart;
+    r->to = (unsigned long)S->patch_array[i].to;
+    r->proc_addr = S->patch_array[i].proc_addr;
+  }
+  for (i = 0; i < S->trace_nbbs; i++) {
+    entry = S->trace_bbs[i];
+    if ((entry->trans_bb_eip >= (unsigned long)tstart) &&
+	(entry->trans_bb_eip < (unsigned long)tend)) {
+      r = &t->relocs[t->nrelocs++];
+      r->kind = SPEC_BB;
+      r->offset = entry->trans_bb_eip - (unsigned long)tstart;
+      r->to = entry->src_bb_eip;
+      r->proc_addr = entry->proc_entry;
+    }
+  }
+
+  t->proc_entry = head->proc_entry;
+  t->orig = (unsigned long)tstart;
+  t->len = len;
+  memcpy(t->code, tstart, len);
+
+  pthread_mutex_lock(&spec_lock);
+  spec_staged++;
+  pthread_mutex_unlock(&spec_lock);
+}
+
+/* Translate a target queued by M into S, staging the trace in the
+   next slot if there is one free */
+static void
+spec_translate(machine_t *S, patch_entry *req)
+{
+  unsigned long to = (unsigned long)req->to;
+  unsigned long proc = req->proc_addr - (unsigned long)spec_M + (unsigned long)S;
+  bb_entry *entry;
+  spec_slot *t;
+
+  pthread_mutex_lock(&spec_lock);
+  t = (spec_staged - spec_installed < SPEC_STAGE_LEN) ?
+    &spec_stage[SPEC_SLOT(spec_staged, SPEC_STAGE_LEN)] : NULL;
+  pthread_mutex_unlock(&spec_lock);
+  if (t == NULL)
+    return;
+
+  /* Leave room to the end of the cache, so that xlate_bb does not wipe
+     it halfway through the trace */
+  if (!ROOM_FOR_BB(S) || (S->no_of_bbs + PATCH_ARRAY_LEN >= MAX_BBS))
+    bb_cache_reinit(S);
+
+  /* The code has the procedure entry of the head built into it, which
+     has to be the one M has for it */
+  entry = lookup_bb_eip(S, to);
+  if (entry == NULL)
+    entry = make_bb_entry(S, to, NOT_YET_TRANSLATED, proc);
+  else if (entry->trans_bb_eip != NOT_YET_TRANSLATED)
+    return;
+  else
+    entry->proc_entry = proc;
+
+  t->req = *req;
+  spec_cur = t;
+  S->fixregs.eip = to;
+  S->comming_from_call_indirect = false;
+  xlate_bb(S);
+  spec_cur = NULL;
+}
+
+static void *
+spec_helper(void *arg)
+{
+  machine_t *S = spec_S;
+  patch_entry req;
+
+  for (;;) {
+    pthread_mutex_lock(&spec_lock);
+    while (spec_taken == spec_queued)
+      pthread_cond_wait(&spec_wake, &spec_lock);
+    req = spec_queue[SPEC_SLOT(spec_taken, SPEC_QUEUE_LEN)];
+    spec_taken++;
+    pthread_mutex_unlock(&spec_lock);
+
+    spec_translate(S, &req);
+  }
+  return NULL;
+}
+
+/* Set up S and start the helper, for M */
+static bool
+spec_start(machine_t *M)
+{
+  size_t mapSize = SPEC_S_SIZE;
+  pthread_t tid;
+  sigset_t oldSet;
+  machine_t *S;
+
+  S = (machine_t *) mmap(0, mapSize, PROT_READ | PROT_WRITE | PROT_EXEC,
+			 MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, 0, 0);
+  if (S == MAP_FAILED)
+    return false;
+  S->ismmaped = true;
+  S->ptState = (pt_state *)(((unsigned char *)S) + sizeof(machine_t));
+  S->guest_start_eip = M->guest_start_eip;
+  bb_cache_init(S);
+
+  spec_M = M;
+  spec_S = S;
+  spec_pid = getpid();
+
+  /* The helper takes no signals of the guest's: it starts with all of
+     them blocked */
+  pthread_sigmask(SIG_SETMASK, &allSignals, &oldSet);
+  if (pthread_create(&tid, NULL, spec_helper, NULL) != 0) {
+    DEBUG(xlate)
+      fprintf(DBG, "Cannot start the speculative translator\n");
+    spec_pid = 0;
+  }
+  pthread_sigmask(SIG_SETMASK, &oldSet, NULL);
+  return spec_pid != 0;
+}
+
+/* Queue the targets that M noted in M->spec_array */
+static void
+spec_post(machine_t *M)
+{
+  unsigned long i;
+
+  if (M->spec_count == 0)
+    return;
+  if ((spec_M == NULL) && !spec_start(M))
+    spec_M = M;
+  if ((M != spec_M) || (spec_pid != getpid()))
+    return;
+
+  pthread_mutex_lock(&spec_lock);
+  for (i = 0; (i < M->spec_count) && 
+	 (spec_queued - spec_taken < SPEC_QUEUE_LEN); i++)
+    spec_queue[SPEC_SLOT(spec_queued++, SPEC_QUEUE_LEN)] = M->spec_array[i];
+  pthread_cond_signal(&spec_wake);
+  pthread_mutex_unlock(&spec_lock);
+}
+
+/* Put the trace staged in t at M->bbOut, and link the jump it was
+   queued for */
+static void
+spec_install_trace(machine_t *M, spec_slot *t)
+{
+  unsigned long to = (unsigned long)t->req.to;
+  bb_entry *head = lookup_bb_eip(M, to);
+  unsigned char *tstart = M->bbOut;
+  unsigned char *at = t->req.at;
+  unsigned char *pb;
+  unsigned long orig_end = t->orig + t->len;
+  unsigned long i, dest;
+  long delta;
+  spec_reloc *r;
+  bb_entry *entry;
+
+  if (head == NULL)
+    return;
+
+  if (head->trans_bb_eip == NOT_YET_TRANSLATED) {
+    /* Room for the code, its patch blocks and its bb_entries */
+    if ((head->proc_entry != spec_to_M(t->proc_entry)) ||
+	((M->bbLimit - M->bbOut) <= (long)(t->len + BYTES_NEEDED_AT_THE_END)) ||
+	(M->no_of_bbs + t->nrelocs >= MAX_BBS))
+      return;
+
+    memcpy(tstart, t->code, t->len);
+    M->bbOut = tstart + t->len;
+    delta = (long)tstart - (long)t->orig;
+
+    M->patch_count = 0;
+    for (i = 0; i < t->nrelocs; i++) {
+      r = &t->relocs[i];
+      pb = tstart + r->offset;
+
+      switch (r->kind) {
+      case PP_REL32:
+	dest = t->orig + r->offset + 4 + *((long *)pb);
+	if ((dest >= t->orig) && (dest < orig_end))
+	  break;
+	if (spec_in_S(dest))
+	  dest = spec_to_M(dest);
+	*((long *)pb) = dest - ((unsigned long)pb + 4);
+	break;
+
+      case PP_ABS32:
+	dest = *((unsigned long *)pb);
+	if ((dest >= t->orig) && (dest <= orig_end))
+	  *((unsigned long *)pb) = dest + delta;
+	break;
+
+      case PP_MABS32:
+	*((unsigned long *)pb) = spec_to_M(*((unsigned long *)pb));
+	break;
+
+      case SPEC_PATCH:
+	M->patch_array[M->patch_count].at = pb;
+	M->patch_array[M->patch_count].to = (unsigned char *)r->to;
+	M->patch_array[M->patch_count].proc_addr = spec_to_M(r->proc_addr);
+	M->patch_count++;
+	break;
+
+      case SPEC_BB:
+	entry = lookup_bb_eip(M, r->to);
+	if (entry == NULL)
+	  make_bb_entry(M, r->to, (unsigned long)pb, spec_to_M(r->proc_addr));
+	else if (entry->trans_bb_eip == NOT_YET_TRANSLATED)
+	  entry->trans_bb_eip = (unsigned long)pb;
+	break;
+      }
+    }
+    emit_patch_blocks(M);
+
+    DEBUG(xlate) {
+      fprintf(DBG, "Installed trace of %lx translated ahead, %lu bytes\n", 
+	      to, t->len);
+      fflush(DBG);
+    }
+  }
+
+  /* Link the jump, if it still goes to the patch block for to */
+  if ((at >= M->bbCache_main) && (at + 4 <= M->bbOut)) {
+    pb = at + 4 + *((long *)at);
+    if ((pb >= M->bbCache_main) && (pb + PATCH_BLOCK_LEN <= M->bbOut) && 
+	(pb[0] == 0xE8u) &&
+	(*((unsigned long *)(pb + 5)) == to) && 
+	(*((unsigned char **)(pb + 9)) == at)
+#ifdef SHARED_DUMP_CODE
+	&& ((at + 4 <= M->shared_lo) || (at >= M->shared_hi))
+#endif
+	)
+      *((unsigned long *)at) = head->trans_bb_eip - ((unsigned long)at + 4);
+  }
+}
+
+/* Put in M the traces that the helper has staged since last time */
+static void
+spec_install(machine_t *M)
+{
+  unsigned long n, end;
+
+  /* A forked child has M, but not the helper, and spec_lock may have
+     been held when it was forked */
+  if ((M != spec_M) || (spec_pid != getpid()))
+    return;
+
+  pthread_mutex_lock(&spec_lock);
+  end = spec_staged;
+  pthread_mutex_unlock(&spec_lock);
+
+  for (n = spec_installed; n != end; n++)
+    spec_install_trace(M, &spec_stage[SPEC_SLOT(n, SPEC_STAGE_LEN)]);
+
+  pthread_mutex_lock(&spec_lock);
+  spec_installed = end;
+  pthread_mutex_unlock(&spec_lock);
+}
@@ -53,6 +53,38 @@
 /* Turn on Return cache optimizations*/
 #define CALL_RET_OPT
 
+/* Follow direct calls into short leaf callees: the callee is copied
+   into the calling trace and its ret becomes a check of the return
+   address, falling through to the return site. Needs CALL_RET_OPT,
+   and is not used by the static pass */
+/* #define FOLLOW_CALLS */
+
+#ifdef FOLLOW_CALLS
+/* Longest callee that is followed, ret included */
+#define FOLLOW_CALL_MAX_INSTRS 8
+#endif /* FOLLOW_CALLS */
+
+/* Decode with the direct-dispatch decoder that is generated along
+   with the opcode tables, rather than by walking the tables */
+#define DIRECT_DECODE
+
+/* Keep compact records, page by page, of the instructions that the
+   fast path does not handle, outside bbCache, so that retranslating
+   after the cache is flushed does not decode them again. A page's
+   records are only used while its bytes are unchanged, which is
+   checked once per page after each flush. Not used by the static
+   pass */
+/* #define DECODE_CACHE */
+
+#ifdef DECODE_CACHE
+/* Guest pages with records (a power of 2), 1MB of guest code, and
+   records per page (a power of 2). A page of compiled code has about
+   200 instructions that the fast path leaves, and the records are an
+   open hash, so keep this well above that */
+#define DCACHE_PAGES     256
+#define DCACHE_PAGE_RECS 512
+#endif /* DECODE_CACHE */
+
 /* Build BBHeaders for Conditional Jumps: This will also
    avoid code-duplication if (straight line) target has already been 
    translated */
@@ -75,6 +107,100 @@
 #define SMALL_HASH
 #endif /* USE_SIEVE */
 
+/* Peephole pass over every finished trace: removes jumps to the
+   next instruction, threads jumps to jumps and shortens some of the
+   fixed-size encodings used by the emitters */
+/* #define PEEPHOLE_OPT */
+
+#ifdef PEEPHOLE_OPT
+/* Use the rel8 forms of jmp / jcc for patch points that are resolved
+   at translation time, and compact the trace to match */
+#define PEEPHOLE_SHORT_BRANCHES
+#endif /* PEEPHOLE_OPT */
+
+/* Alignment of trace heads in the code cache: pad up to the next
+   TRACE_ALIGN boundary when that takes at most TRACE_ALIGN_MAX_PAD
+   bytes. The padding sits after the patch blocks of the previous
+   trace, so it is never executed */
+/* #define TRACE_ALIGN 16 */
+
+#ifdef TRACE_ALIGN
+#define TRACE_ALIGN_MAX_PAD (TRACE_ALIGN - 1)
+
+#ifdef PEEPHOLE_OPT
+/* Also align targets of backward jumps within a trace (loop heads).
+   This padding is run through once on entry to the loop, so keep it
+   short */
+#define LOOP_ALIGN_MAX_PAD 7
+#endif /* PEEPHOLE_OPT */
+#endif /* TRACE_ALIGN */
+
+/* Have a helper thread translate ahead the targets left pending
+   (behind patch blocks) by a trace translated for a patch block, into
+   a machine of its own. Its traces are moved into bbCache and linked
+   in the next time the translator is entered for a patch block, which
+   saves the guest a translation for each target that does get run. Not
+   used by the static pass */
+/* #define SPECULATIVE_XLATE */
+
+#ifdef SPECULATIVE_XLATE
+/* Most targets queued after one patch block */
+#define SPEC_XLATE_MAX 4
+
+/* Targets queued, and traces staged for the translator (powers of 2),
+   and the largest trace staged */
+#define SPEC_QUEUE_LEN 64
+#define SPEC_STAGE_LEN 32
+#define SPEC_TRACE_MAX_BYTES 4096
+#define SPEC_TRACE_RELOCS_MAX 512
+#endif /* SPECULATIVE_XLATE */
+
+/* Keep a copy of each of the most recently translated traces, with
+   the sites that refer to code addresses, in a buffer outside bbCache.
+   When a trace is needed again after the cache has been flushed, its
+   copy is put back and relocated rather than translated again. Not
+   used by the static pass */
+/* #define RECYCLE_TRACES */
+
+#ifdef RECYCLE_TRACES
+/* Bytes of code kept (a power of 2), and the longest trace kept */
+#define RECYCLE_CODE_SIZE (512 * 1024)
+#define RECYCLE_TRACE_MAX_BYTES 4096
+
+/* Traces and relocation records kept (powers of 2) */
+#define RECYCLE_TRACES_MAX 4096
+#define RECYCLE_RELOCS_MAX 32768
+#endif /* RECYCLE_TRACES */
+
+/* Append the new traces in bbCache at exit to a file per module under
+   /tmp/vdebug-traces-<uid>, keyed by the module's path and build-id,
+   with a relocation record for every address built into them, and load
+   them into bbCache at startup. The traces of a library are shared by
+   every program of the user that maps it. Unlike USE_STATIC_DUMP, nothing
+   has to be mapped at a fixed address: the records are rebased to
+   wherever M, the translator and the guest's modules land in this
+   run. Not used by the static pass */
+/* #define PERSIST_TRACES */
+
+#ifdef PERSIST_TRACES
+/* Traces and relocation records kept for the file, for the traces
+   translated since the cache was last wiped */
+#define PERSIST_TRACES_MAX 16384
+#define PERSIST_RELOCS_MAX (128 * 1024)
+#endif /* PERSIST_TRACES */
+
+/* The emitters note the sites of each trace that refer to code
+   addresses, for the passes above that need them. For PERSIST_TRACES
+   and SPECULATIVE_XLATE they also note the addresses of M and of the
+   guest */
+#if defined(PEEPHOLE_OPT) || defined(RECYCLE_TRACES) || \
+    defined(PERSIST_TRACES) || defined(SPECULATIVE_XLATE)
+#define NOTE_SITES
+#endif
+#if defined(PERSIST_TRACES) || defined(SPECULATIVE_XLATE)
+#define NOTE_ADDR_SITES
+#endif
+
 /********************************************************/
 /*              Profiling Options                       */
 /********************************************************/
@@ -88,10 +214,28 @@
 			    // with PROFILE flag.
 //#define PROFILE_BB_STATS_DISASM  //    ,, 
 //#define PROFILE_TRANSLATION
+//#define PROFILE_XLATE_PHASES // Split of the translation time into phases,
+                               // emitters and slowest traces, in the timer
+                               // file. Implies PROFILE_TRANSLATION.
  
-/* Output the Basic Block directory in the end */
+/* Output the guest addresses of the traces translated, in the order
+   that they were first run, in the end (bbstat, which sgen -p takes as
+   a profile). A trace translated again after a cache flush is listed
+   again. Traces reloaded from a dump are not translated, so are not
+   listed: profile a run that starts cold */
 //#define OUTPUT_BB_STAT
 
+#ifdef OUTPUT_BB_STAT
+#define BBSTAT_LOG_LEN 65536
+#endif
+
+#ifdef PROFILE_XLATE_PHASES
+#define PROFILE_TRANSLATION
+
+/* No. of the slowest traces reported */
+#define XP_SLOW_TRACES 16
+#endif /* PROFILE_XLATE_PHASES */
+
 /* Note: All profiling measurements involving counters are
    single-threaded versions. */
 
@@ -106,6 +250,32 @@
     used with STATIC_DUMP option */
 /* #define CHECK_DUMP_DIR */
 
+/* Map the code of a reloaded dump from the file shared and read-only,
+   rather than privately, so that all the processes running the same
+   program keep one copy of it between them. Exits from that code that
+   were not linked when it was dumped are sent through a stub in M,
+   which is private, and it is the stub that gets patched. Past
+   SHARED_STUBS_MAX of them, an exit goes through the dispatcher each
+   time instead. Used with USE_STATIC_DUMP */
+/* #define SHARED_DUMP_CODE */
+
+#ifdef SHARED_DUMP_CODE
+#define SHARED_STUBS_MAX 16384
+#define SHARED_STUB_LEN  5	/* JMP rel32 */
+#endif /* SHARED_DUMP_CODE */
+
+/* Record which pages of a reloaded dump a run touches before it has
+   translated DUMP_PAGES_XLATES traces of its own, in <exe>-pages next
+   to the dump, and have the runs that reload the dump after it
+   populate just those pages up front. Only the first run to reload a
+   dump records them, as one that populated them would find them all
+   in use. Used with USE_STATIC_DUMP */
+/* #define PREFETCH_DUMP_PAGES */
+
+#ifdef PREFETCH_DUMP_PAGES
+#define DUMP_PAGES_XLATES 256
+#endif /* PREFETCH_DUMP_PAGES */
+
 /* Static Trace Generation Pass */
 /* This option should almost always be provided from the Makefile */
 /* This onl generates traces given a set of entry
@@ -141,6 +311,4 @@
 /* #define CALL_DISP_CC_OPT */
 /* #endif */
 
-/* #define TOUCH_RELOADED_BBCACHE_PAGES */
-
 #endif /* SWITCHES_H */
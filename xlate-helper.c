@@ -84,6 +84,20 @@ note_patch(machine_t *M, unsigned char *at, unsigned char *to, unsigned long pro
   M->patch_count ++;
 }  
 
+#ifdef NOTE_SITES
+/* Remember the bb_entries whose translation is part of the current
+   trace, the peephole pass has to move them along with the code, and
+   RECYCLE_TRACES has to set them up again */
+static inline void
+note_trace_bb(machine_t *M, bb_entry *entry)
+{
+  if (M->trace_nbbs < PP_TRACE_BBS)
+    M->trace_bbs[M->trace_nbbs++] = entry;
+  else
+    M->pp_overflow = true;
+}
+#endif /* NOTE_SITES */
+
 static inline bool
 continue_trace(machine_t *M, decode_t *d, unsigned long jmp_destn)
 {
@@ -95,6 +109,9 @@ continue_trace(machine_t *M, decode_t *d, unsigned long jmp_destn)
     bb_entry *new_bb_entry = make_bb_entry(M, jmp_destn, (unsigned long)M->bbOut, M->curr_bb_entry->proc_entry);
     M->next_eip = (unsigned long) jmp_destn;
     M->curr_bb_entry = new_bb_entry;
+#ifdef NOTE_SITES
+    note_trace_bb(M, new_bb_entry);
+#endif
 
     return false;
   }
@@ -105,6 +122,9 @@ continue_trace(machine_t *M, decode_t *d, unsigned long jmp_destn)
 
     M->next_eip = (unsigned long) jmp_destn;
     M->curr_bb_entry = entry;
+#ifdef NOTE_SITES
+    note_trace_bb(M, entry);
+#endif
 
     return false;
   }
@@ -115,6 +135,9 @@ continue_trace(machine_t *M, decode_t *d, unsigned long jmp_destn)
 
   bb_emit_jump (M, 0);		/* Dummy jump instruction which would be patched later by the translator */
   note_patch(M, M->bbOut - 4, (unsigned char *)jmp_destn, M->curr_bb_entry->proc_entry);
+#ifdef NOTE_SITES
+  bb_note_site(M, PP_JMP, M->bbOut - 5, M->bbOut - 4);
+#endif
   
   return true;
 }
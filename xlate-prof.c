@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2005, Johns Hopkins University and The EROS Group, LLC.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials provided
+ *    with the distribution.
+ *
+ *  * Neither the name of the Johns Hopkins University, nor the name
+ *    of The EROS Group, LLC, nor the names of their contributors may
+ *    be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/***********************************************************************
+                  Per-phase profile of the translator
+************************************************************************/
+
+/* With PROFILE_XLATE_PHASES, xlate_bb and the sieves read the time
+   stamp counter between the phases of a translation (XP_LOOKUP ...
+   XP_FLUSH) and around each call to an emitter. The figures go to
+   the timer file along with those of PROFILE_TRANSLATION. The reads
+   themselves cost some cycles, which are charged to the phases. */
+
+/* Charge the cycles since "since" to phase, and return the time now,
+   which is where the next phase starts */
+static inline unsigned long long
+xp_phase(machine_t *M, unsigned long phase, unsigned long long since)
+{
+  unsigned long long now = read_timer();
+
+  M->ptState->xp_cycles[phase] += now - since;
+  M->ptState->xp_count[phase]++;
+  return now;
+}
+
+/* Charge the cycles of one call to the emitter of ds, which emitted n
+   instructions */
+static void
+xp_emitter_done(machine_t *M, decode_t *ds, unsigned long n,
+		unsigned long long cycles)
+{
+  pt_state *P = M->ptState;
+  unsigned long i;
+
+  for (i = 0; i < P->xp_nemitters; i++)
+    if (P->xp_emitters[i].emitfn == (const void *)ds->emitfn)
+      break;
+
+  if (i == P->xp_nemitters) {
+    if (i == XP_MAX_EMITTERS)
+      return;
+    P->xp_emitters[i].emitfn = (const void *)ds->emitfn;
+    P->xp_emitters[i].name = (ds->pEntry != NULL) ? 
+      ((OpCode *)ds->pEntry)->emitter_name : "?";
+    P->xp_nemitters++;
+  }
+
+  P->xp_emitters[i].count += n;
+  P->xp_emitters[i].cycles += cycles;
+}
+
+/* Keep the trace of head eip among the slowest ones */
+static void
+xp_trace_done(machine_t *M, unsigned long eip, unsigned long instrs,
+	      unsigned long long cycles)
+{
+  xp_trace *slowest = M->ptState->xp_slowest;
+  long i;
+
+  if (cycles <= slowest[XP_SLOW_TRACES - 1].cycles)
+    return;
+
+  for (i = XP_SLOW_TRACES - 1; (i > 0) && (slowest[i-1].cycles < cycles); i--)
+    slowest[i] = slowest[i-1];
+  slowest[i].eip = eip;
+  slowest[i].instrs = instrs;
+  slowest[i].cycles = cycles;
+}
+
+static const char *xp_phase_names[XP_NPHASES] = {
+  "lookup", "decode", "emit", "patch blocks", "sieve", "flush"
+};
+
+void
+xlate_prof_report(machine_t *M, FILE *f)
+{
+  pt_state *P = M->ptState;
+  unsigned long long total = 0;
+  unsigned long i, j, best;
+  bool done[XP_MAX_EMITTERS];
+
+  for (i = 0; i < XP_NPHASES; i++)
+    total += P->xp_cycles[i];
+
+  fprintf(f, "Phase           Cycles         Count      %%\n");
+  for (i = 0; i < XP_NPHASES; i++)
+    fprintf(f, "%-12s %12llu %10lu %7.3f\n", xp_phase_names[i],
+	    P->xp_cycles[i], P->xp_count[i], PERC(P->xp_cycles[i], total));
+
+  /* Emitters, most cycles first */
+  fprintf(f, "\nEmitter                       Cycles     Instrs  Cycles/instr\n");
+  for (i = 0; i < P->xp_nemitters; i++)
+    done[i] = false;
+  for (j = 0; j < P->xp_nemitters; j++) {
+    best = P->xp_nemitters;
+    for (i = 0; i < P->xp_nemitters; i++)
+      if (!done[i] && ((best == P->xp_nemitters) ||
+		       (P->xp_emitters[i].cycles > P->xp_emitters[best].cycles)))
+	best = i;
+    done[best] = true;
+    fprintf(f, "%-24s %12llu %10lu %10.1f\n", P->xp_emitters[best].name,
+	    P->xp_emitters[best].cycles, P->xp_emitters[best].count,
+	    (float)P->xp_emitters[best].cycles / P->xp_emitters[best].count);
+  }
+
+  fprintf(f, "\nSlowest traces: head eip, cycles, instrs\n");
+  for (i = 0; (i < XP_SLOW_TRACES) && (P->xp_slowest[i].cycles != 0); i++)
+    fprintf(f, "%08lx %12llu %6lu\n", P->xp_slowest[i].eip,
+	    P->xp_slowest[i].cycles, P->xp_slowest[i].instrs);
+  fprintf(f, "\n\n");
+}
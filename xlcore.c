@@ -54,6 +54,15 @@
 #include <errno.h>
 #include <string.h>
 #include <stdlib.h>
+#ifdef PERSIST_TRACES
+#define __USE_GNU
+#include <link.h>
+#undef __USE_GNU
+#include <sys/file.h>
+#endif
+#ifdef SPECULATIVE_XLATE
+#include <pthread.h>
+#endif
 
 #ifdef INLINE_EMITTERS
 #define INLINE static inline
@@ -90,6 +99,10 @@ inline_emit_normal(machine_t *M, decode_t *d)
 }
 #endif /* INLINE_EMITTERS */
 
+#ifdef PROFILE_XLATE_PHASES
+#include "xlate-prof.c"
+#endif
+
 #ifdef USE_SIEVE
 #ifdef SEPARATE_SIEVES 
 #include "chtable.c"
@@ -149,6 +162,10 @@ xlate_for_sieve (machine_t *M)
   entry_node = xlate_bb(M);
 
 #ifdef USE_SIEVE
+#ifdef PROFILE_XLATE_PHASES
+  unsigned long long xp_t = read_timer();
+#endif
+
   /*   bucket =  */
   /*     (bucket_entry *)(M->hash_table + (((unsigned long)entry_node->src_bb_eip) & SIEVE_HASH_MASK)); */
 
@@ -229,6 +246,9 @@ xlate_for_sieve (machine_t *M)
 #ifdef PROFILE
   M->ptState->hash_nodes_cnt++;
 #endif
+#ifdef PROFILE_XLATE_PHASES
+  xp_phase(M, XP_SIEVE, xp_t);
+#endif
 #endif /* USE_SIEVE */
 }
 
@@ -407,6 +427,12 @@ bb_setup_slow_dispatch_bb(machine_t *M)
 }
 #endif /* USE_SIEVE */
 
+#if defined(SPECULATIVE_XLATE) && !defined(STATIC_PASS)
+/* In spec.c */
+static void spec_install(machine_t *M);
+static void spec_post(machine_t *M);
+#endif
+
 void
 xlate_for_patch_block(machine_t *M) 
 {
@@ -418,12 +444,25 @@ xlate_for_patch_block(machine_t *M)
 				       ((M->backpatch_block) + 4)));
   M->comming_from_call_indirect = false;
 
+#if defined(SPECULATIVE_XLATE) && !defined(STATIC_PASS)
+  /* Traces translated ahead since we were last here */
+  spec_install(M);
+  M->spec_count = 0;
+#endif
+
   //Translate the target
   xlate_bb(M);
 
-  // Patch at patch_point
+  // Patch at patch_point, unless it is in code shared with other processes
+#ifdef SHARED_DUMP_CODE
+  if ((M->patch_point + 4 <= M->shared_lo) || (M->patch_point >= M->shared_hi))
+#endif
   *((unsigned long *)(M->patch_point)) = (M->jmp_target - 
 					  (M->patch_point + 4));    
+
+#if defined(SPECULATIVE_XLATE) && !defined(STATIC_PASS)
+  spec_post(M);
+#endif
 }
 
 INLINE void
@@ -792,11 +831,29 @@ bb_cache_reinit(machine_t *M)
 {
   int i;
 
+#ifdef DECODE_CACHE
+  /* Pages of the decode cache are checked again on their next use */
+  M->dcache_epoch++;
+#endif
+
 #ifdef PROFILE_BB_STATS
   bb_cache_init(M);
   return;
 #endif
 
+#ifdef SHARED_DUMP_CODE
+  /* The cache is about to be written over, so it can no longer be
+     shared */
+  if (M->shared_hi > M->shared_lo) {
+    if (mmap(M->shared_lo, M->shared_hi - M->shared_lo,
+	     PROT_READ | PROT_WRITE | PROT_EXEC,
+	     MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) == MAP_FAILED)
+      panic("Unsharing the code cache failed err = %s", strerror(errno));
+    M->shared_lo = M->shared_hi = NULL;
+  }
+  M->shared_nstubs = 0;
+#endif
+
   M->bbOut = M->bbCache;
 #ifdef USE_SIEVE
   bb_setup_hash_table(M);
@@ -814,6 +871,19 @@ bb_cache_reinit(machine_t *M)
 
   for(i=0; i<CALL_TABLE_SIZE; i++)
     M->call_hash_table[i] = (unsigned long) M->ret_calls_fast_dispatch_bb;
+
+#ifdef PERSIST_TRACES
+  M->ps_ntraces = 0;
+  M->ps_nrelocs = 0;
+#endif
+}
+
+/* Start over with an empty cache. For the translator benchmark in
+   decode-tester, which translates into a machine of its own */
+void
+xlate_reset(machine_t *M)
+{
+  bb_cache_reinit(M);
 }
 
 
@@ -844,42 +914,58 @@ panic_decode_fail(unsigned long eip, unsigned long bAddr)
 }
 
 #ifdef STATIC_PASS  
-static bool 
+/* Point M->mem_next_eip at the copy of M->next_eip in the file. The
+   code segments in M->sec_info are sorted by address */
+static inline bool 
 update_mem_next_eip(machine_t *M)
 {
-  int i;
-  i = M->curr_sec_index;
+  unsigned long eip = M->next_eip;
+  unsigned long i = M->curr_sec_index;
+  unsigned long lo, hi;
   bool found = false;
 
-  /* Usually in the same section */
-  if((M->sec_info[i].start <= M->next_eip) && (M->sec_info[i].end >= M->next_eip)) {
+  /* Usually in the same segment */
+  if((M->sec_info[i].start <= eip) && (eip < M->sec_info[i].end)) {
     found = true;
   }
   else {
-    /* If not, find it the hard way */
-    for(i=0;(!found) && (i<M->nsections); i++) 
-      if((M->sec_info[i].start <= M->next_eip) && (M->sec_info[i].end >= M->next_eip)) {
+    /* If not, find it by bisection */
+    lo = 0;
+    hi = M->nsections;
+    while(lo < hi) {
+      i = (lo + hi) / 2;
+      if(eip < M->sec_info[i].start)
+	hi = i;
+      else if(eip >= M->sec_info[i].end)
+	lo = i + 1;
+      else {
 	found = true;
 	break;
       }
+    }
   }
 
   if(found) {
-    DEBUG(static_pass_addr_trans)
-      fprintf(DBG, "\t#%lx: [%s]\n",M->next_eip, M->sec_info[i].name);
     M->mem_next_eip = (unsigned long) (M->sec_info[i].inmem + 
-				       (M->next_eip - (unsigned long)M->sec_info[i].start));
-    M->curr_sec_index = i;
+				       (eip - M->sec_info[i].start));
+    if(i != M->curr_sec_index) {
+      M->curr_sec_index = i;
+      DEBUG(static_pass_addr_trans) {
+	fprintf(DBG, "\t#%lx: [%s]\n", eip, M->sec_info[i].name);
+	fflush(DBG);
+      }
+    }
   }
   else {
-    DEBUG(static_pass_addr_trans)
-      fprintf(DBG, "\t@%lx: Not Found\n",M->next_eip);  
+    DEBUG(static_pass_addr_trans) {
+      fprintf(DBG, "\t@%lx: Not Found\n", eip);  
+      fflush(DBG);
+    }
   }
-  fflush(DBG);
   return !found;
 }
 
-static void
+void
 simple_patch(machine_t *M, unsigned long at, unsigned long addr)
 {
   unsigned char *tmp = M->bbOut;
@@ -887,20 +973,212 @@ simple_patch(machine_t *M, unsigned long at, unsigned long addr)
   bb_emit_w32(M, addr - (at + 4));
   M->bbOut = tmp;
 }
+
+/* For the sgen driver: point the patch point /at/, whose target /to/
+   was not translated, at a new patch block for it */
+void
+sgen_patch_block(machine_t *M, unsigned long at, unsigned long to,
+		 unsigned long proc)
+{
+  simple_patch(M, at, (unsigned long)M->bbOut);
+  bb_emit_byte (M, 0xE8u);	/* CALL rel32 */
+  bb_emit_w32 (M, (unsigned long) (M->backpatch_and_dispatch_bb - (unsigned long)(M->bbOut + 4)));
+  bb_emit_w32 (M, to);
+  bb_emit_w32 (M, at);
+  if (lookup_bb_eip(M, to) == NULL)
+    make_bb_entry(M, to, NOT_YET_TRANSLATED, proc);
+}
+
+/* For the sgen driver: keep room for /n/ patch blocks below /limit/,
+   out of the reach of xlate_bb(), if there is that much room left */
+bool
+keep_patch_blocks(machine_t *M, const unsigned char *limit, unsigned long n)
+{
+  if ((unsigned long)(limit - M->bbOut) < n * PATCH_BLOCK_LEN)
+    return false;
+  M->bbLimit = limit - n * PATCH_BLOCK_LEN;
+  return true;
+}
+
+/* For the sgen driver: can xlate_bb() translate one more trace
+   without wiping the cache? */
+bool
+room_for_bb(machine_t *M)
+{
+  return (ROOM_FOR_BB(M) && (M->no_of_bbs < MAX_BBS));
+}
+
+/* For the sgen driver: enter the bb_entry of a trace that a worker
+   translated. The first translation of /src/ to be merged is kept */
+void
+merge_bb_entry(machine_t *M, unsigned long src, unsigned long trans, 
+	       unsigned long proc)
+{
+  bb_entry *entry = lookup_bb_eip(M, src);
+
+  if (entry == NULL)
+    make_bb_entry(M, src, trans, proc);
+  else if (entry->trans_bb_eip == NOT_YET_TRANSLATED)
+    entry->trans_bb_eip = trans;
+}
 #endif  
 
-#define PATCH_BLOCK_LEN 13 /* WARNING: Sensitive to size of Patch-block */
-#define MAX_PATCH_BLOCK_BYTES (PATCH_ARRAY_LEN * PATCH_BLOCK_LEN)
+#ifdef PEEPHOLE_OPT
+#include "peephole.c"
+#endif
+
+#ifdef TRACE_ALIGN
+/* Pad up to the next TRACE_ALIGN boundary before starting a new
+   trace. Whatever precedes M->bbOut (patch blocks, or the dispatch
+   code right after a flush) never falls through, so the padding is
+   never executed */
+INLINE void
+bb_align_trace_head(machine_t *M)
+{
+  unsigned long pad = (-(unsigned long)M->bbOut) & (TRACE_ALIGN - 1);
+
+  if ((pad == 0) || (pad > TRACE_ALIGN_MAX_PAD))
+    return;
+
+  bb_emit_nops(M, pad);
+#ifdef PROFILE
+  M->ptState->align_pad_bytes += pad;
+  M->ptState->aligned_traces++;
+#endif
+}
+#endif /* TRACE_ALIGN */
+
+#if defined(DECODE_CACHE) && !defined(STATIC_PASS)
+#include "dcache.c"
+#endif
+
+/* Decode from M->next_eip into M->ibuf, up to and including the first
+   instruction that is not a normal one. Decoding also stops when the
+   buffer fills up, on an illegal instruction (whose partial decode is
+   left in M->ibuf[n]) or, in the static pass, on leaving the current
+   elf file. M->next_eip is left where decoding stopped. Returns the
+   number n of instructions decoded */
+static unsigned long
+decode_run(machine_t *M, bool *decodeFailed, bool *goingOutofElf)
+{
+  unsigned long n = 0;
+  bool ok;
+
+  *decodeFailed = false;
+  while (n < IBUF_LEN) {
+#ifdef STATIC_PASS
+    *goingOutofElf = update_mem_next_eip(M);
+    if (*goingOutofElf)
+      break;
+#endif
 
-/* Conservative estimate used to determine if there is more room for this BB.
-   Space needed for all patch_blocks + space for at least one instruction 
-   I guess no emitted sequence of instructions per single instruction currently
-   exceeds 64 bytes. If it does, fix the next line */
-#define BYTES_NEEDED_AT_THE_END (MAX_PATCH_BLOCK_BYTES + 64)
+    /* Most instructions are normal ones, whose length is all that is
+       needed. The disassembly debug output needs the full decode */
+    if (!CND_DEBUG(show_each_instr_trans) && do_decode_fast(M, &M->ibuf[n])) {
+      n++;
+      continue;
+    }
 
-#define ROOM_FOR_BB(M) ((M->bbLimit - M->bbOut) > BYTES_NEEDED_AT_THE_END)
-#define MORE_FREE_PATCH_BLOCKS(M) (M->patch_count <= (PATCH_ARRAY_LEN - 4))  /* Leave some extra room for cases like
-										call that need multiple patch_blocks */
+#if defined(DECODE_CACHE) && !defined(STATIC_PASS)
+    if (!CND_DEBUG(show_each_instr_trans) && dcache_lookup(M, &M->ibuf[n])) {
+      if ((void *)M->ibuf[n++].emitfn != (void *)emit_normal)
+	break;
+      continue;
+    }
+#endif
+
+#ifdef DIRECT_DECODE
+    ok = do_decode_direct(M, &M->ibuf[n]);
+#else
+    ok = do_decode(M, &M->ibuf[n]);
+#endif
+    if (ok == false) {
+      *decodeFailed = true;
+      break;
+    }
+#if defined(DECODE_CACHE) && !defined(STATIC_PASS)
+    dcache_insert(M, &M->ibuf[n]);
+#endif
+
+    if ((void *)M->ibuf[n++].emitfn != (void *)emit_normal)
+      break;
+  }
+  return n;
+}
+
+/* Passes over each decoded run, called in order before the run is
+   emitted. A pass may annotate or rewrite the records in M->ibuf, but
+   not add or remove any, or change their guest addresses */
+typedef void (*xlate_pass_t)(machine_t *M, decode_t *run, unsigned long n);
+
+static const xlate_pass_t xlate_passes[] = {
+  NULL
+};
+
+#ifndef STATIC_PASS
+/* Link each patch point noted in M->patch_array to the translation of
+   its target, or else to a new patch block */
+static void
+emit_patch_blocks(machine_t *M)
+{
+  unsigned long i;
+  unsigned char *tmp;
+
+  for (i = 0 ; i < M->patch_count ; i ++) {
+    bb_entry *entry = NULL; 
+    unsigned long addr;
+    unsigned long to = (unsigned long)M->patch_array[i].to;
+    unsigned long at = (unsigned long)M->patch_array[i].at;
+
+    entry = lookup_bb_eip (M, to);
+    if ((entry != NULL) && (entry->trans_bb_eip != NOT_YET_TRANSLATED)) {
+      //		if (entry != NULL)
+      DEBUG(xlate_pb) {
+	fprintf(DBG, "1. Patch Block: BB Already found\n");
+	fflush(DBG);
+      }
+      addr = entry->trans_bb_eip;
+      /* If found to be translated already, patch the jump destination right now to implement chaining */
+      tmp = M->bbOut;
+      M->bbOut = (unsigned char *)at;
+      bb_emit_w32(M, addr - (at + 4));
+      M->bbOut = tmp;
+    }
+    else {
+      /* If not, patch the jump destination so that it jumps to its corresponding patch block */
+      tmp = M->bbOut;
+      M->bbOut = (unsigned char *)at;
+      bb_emit_w32(M, tmp - (M->bbOut + 4));
+      M->bbOut = tmp;
+      
+      /* Then, build the patch block */
+      bb_emit_byte (M, 0xE8u);	/* CALL rel32 */
+      bb_emit_w32 (M, (unsigned long) (M->backpatch_and_dispatch_bb - (unsigned long)(M->bbOut + 4)));
+      bb_emit_w32 (M, to);
+      bb_emit_w32 (M, at);
+      if(entry == NULL) {
+	make_bb_entry(M, to, NOT_YET_TRANSLATED, M->patch_array[i].proc_addr);
+      }
+#ifdef SPECULATIVE_XLATE
+      if (M->spec_count < SPEC_XLATE_MAX)
+	M->spec_array[M->spec_count++] = M->patch_array[i];
+#endif
+    }
+  }
+}
+#endif /* STATIC_PASS */
+
+#if defined(RECYCLE_TRACES) && !defined(STATIC_PASS)
+#include "recycle.c"
+#endif
+
+#if defined(PERSIST_TRACES) && !defined(STATIC_PASS)
+#include "persist.c"
+#endif
+
+#if defined(SPECULATIVE_XLATE) && !defined(STATIC_PASS)
+#include "spec.c"
+#endif
 
 /* THE Translator -- Returns:
    - a pointer to the bb_entry of the required destination
@@ -913,12 +1191,19 @@ simple_patch(machine_t *M, unsigned long at, unsigned long addr)
 bb_entry * 
 xlate_bb(machine_t *M)
 {
-  decode_t ds;				  /* Decode Structure - filled up by do_decode and used by translate_instr   	*/
+  unsigned long nInstrs;		  /* No. of instructions decoded into M->ibuf in this run                   	*/
+  unsigned long run_end;		  /* Guest address where decoding of this run stopped                       	*/
+  bool decodeFailed;			  /* Decoding stopped on an illegal instruction, left in M->ibuf[nInstrs]    	*/
   bool isEndOfBB = true;		  /* Flag to indicate encountering of basic-block terminating instruction    	*/
   bool goingOutofElf = true;
   int i, j;
+  unsigned long k, m;
   unsigned char * tmp;
   bb_entry *prev_bb_entry = NULL;
+#ifdef PROFILE_XLATE_PHASES
+  unsigned long long xp_t = read_timer(), xp_e;
+  unsigned long xp_instrs = 0;
+#endif
   bb_entry *curr_bb_entry = lookup_bb_eip(M, M->fixregs.eip), *temp_entry;
   unsigned long long start_time;
   unsigned long long end_time;
@@ -943,6 +1228,9 @@ xlate_bb(machine_t *M)
     }
 
     M->jmp_target = (unsigned char *)curr_bb_entry->trans_bb_eip;
+#ifdef PROFILE_XLATE_PHASES
+    xp_phase(M, XP_LOOKUP, xp_t);
+#endif
     return curr_bb_entry;
   }
   
@@ -950,6 +1238,20 @@ xlate_bb(machine_t *M)
   start_time = read_timer();
 #endif
 
+#ifdef PREFETCH_DUMP_PAGES
+  dump_pages_check(M);
+#endif
+
+#if defined(OUTPUT_BB_STAT) && !defined(STATIC_PASS)
+  /* The trace is run as soon as it is translated */
+  if (M->bbstat_count < BBSTAT_LOG_LEN)
+    M->bbstat_log[M->bbstat_count++] = M->fixregs.eip;
+#endif
+
+#ifdef TRACE_ALIGN
+  bb_align_trace_head(M);
+#endif
+
   if(curr_bb_entry == NULL) {	    
     if (M->comming_from_call_indirect) {
       curr_bb_entry = make_bb_entry(M, M->fixregs.eip, (unsigned long) M->bbOut, 
@@ -968,6 +1270,9 @@ xlate_bb(machine_t *M)
   else {    
     curr_bb_entry->trans_bb_eip = (unsigned long)M->bbOut;
   }
+#ifdef PROFILE_XLATE_PHASES
+  xp_t = xp_phase(M, XP_LOOKUP, xp_t);
+#endif
 
   
 #ifdef DEBUG_ON
@@ -1016,6 +1321,9 @@ xlate_bb(machine_t *M)
       fprintf(DBG, "Wiping basic block cache\n");
     }
     bb_cache_reinit(M);
+#ifdef PROFILE_XLATE_PHASES
+    xp_phase(M, XP_FLUSH, xp_t);
+#endif
 
 #ifdef SIGNALS    
     sigprocmask(SIG_SETMASK, &allSignals, &oldSet);  
@@ -1023,6 +1331,36 @@ xlate_bb(machine_t *M)
     return xlate_bb(M);
   }
 
+#if defined(RECYCLE_TRACES) && !defined(STATIC_PASS)
+  /* A trace translated before the cache was last wiped */
+  if (rc_recycle_trace(M, curr_bb_entry)) {
+#ifdef PROFILE_XLATE_PHASES
+    xp_t = xp_phase(M, XP_EMIT, xp_t);
+#endif
+    emit_patch_blocks(M);
+#ifdef PROFILE_XLATE_PHASES
+    xp_phase(M, XP_PATCH, xp_t);
+#endif
+#ifdef PROFILE_TRANSLATION
+    end_time = read_timer();
+    M->ptState->trans_time += (end_time - start_time);
+#endif
+#ifdef PROFILE_XLATE_PHASES
+    xp_trace_done(M, curr_bb_entry->src_bb_eip, 0, end_time - start_time);
+#endif
+    return curr_bb_entry;
+  }
+#endif
+
+#ifdef NOTE_SITES
+  unsigned char *trace_start = M->bbOut;
+  M->pp_count = 0;
+  M->trace_nbbs = 0;
+  M->pp_overflow = false;
+  M->pp_active = true;
+  note_trace_bb(M, curr_bb_entry);
+#endif
+
 #ifdef PROFILE_BB_STATS
   bb_entry *this_bb_entry = M->curr_bb_entry;
   this_bb_entry->flags = IS_START_OF_TRACE;
@@ -1030,103 +1368,175 @@ xlate_bb(machine_t *M)
   this_bb_entry->trans_bb_end_eip = (unsigned long) M->bbOut;
 #endif
 
-  /* This loop executes once per instruction */  
+  /* This loop executes once per run of instructions: decode up to
+     the next control transfer, let the passes look at the run, then
+     emit it one instruction at a time */
   while (ROOM_FOR_BB(M) && MORE_FREE_PATCH_BLOCKS(M)) {
     
     /*If it is necessary to limit the trace length (I don't know why)
       use : M->nTrInstr < MAX_TRACE_INSTRS */
     
-    /* See if the instruction needs to be decoded */
-#ifdef STATIC_PASS
-    goingOutofElf = update_mem_next_eip(M); /* Jump to a library etc, outside of the 
-					       current elf file */
-    if (goingOutofElf)
-      break;
+    /* Decode the Instructions */    
+    nInstrs = decode_run(M, &decodeFailed, &goingOutofElf);
+    run_end = M->next_eip;
+
+#ifdef PROFILE_TRANSLATION
+    M->ptState->trans_instrs += nInstrs;
+    if (nInstrs)
+      M->ptState->trans_bytes += run_end - M->ibuf[0].decode_eip;
 #endif
-    
-    /* Decode the Instruction */    
-    if (do_decode(M, &ds) == false) {
 
-      DEBUG(decode_eager_panic) 
-	panic ("do_decode failed at instr: %lx byte: %lx\n",
-	       ds.decode_eip, ds.pInstr);
+    for (i = 0; xlate_passes[i] != NULL; i++)
+      xlate_passes[i](M, M->ibuf, nInstrs);
+#ifdef PROFILE_XLATE_PHASES
+    xp_t = xp_phase(M, XP_DECODE, xp_t);
+    xp_instrs += nInstrs;
+#endif
 
-      // Emit a call to panic ...
-      bb_emit_byte(M, 0x68u);
-      bb_emit_w32(M, (unsigned long) ds.pInstr);      
-      bb_emit_byte(M, 0x68u);
-      bb_emit_w32(M, (unsigned long) M->next_eip);
-      bb_emit_call(M, (unsigned char *) panic_decode_fail);      
-      break;
-    }
+    for (k = 0; k < nInstrs; k = m) {
+      decode_t *ds = &M->ibuf[k];
 
-    DEBUG(show_each_instr_trans) {
-      unsigned long bbno = (M->curr_bb_entry - M->bb_entry_nodes);
-      fprintf(DBG, "bb# %lu, ", bbno);
-      do_disasm(&ds, DBG);
-      fflush(DBG);
-    }
+      if (!ROOM_FOR_BB(M)) {
+	M->next_eip = ds->decode_eip;
+	break;
+      }
+
+      /* Instructions M->ibuf[k..m-1] are emitted together */
+      m = k + 1;
+#if !defined(PROFILE) && !defined(PROFILE_BB_CNT)
+      /* Normal instructions are copied as they are, so a straight run
+	 of them is a single copy, as long as there would have been room
+	 for each of them on its own. (The profiling builds emit counter
+	 updates in between) */
+      if ((void *)ds->emitfn == (void *)emit_normal)
+	while ((m < nInstrs) &&
+	       ((void *)M->ibuf[m].emitfn == (void *)emit_normal) &&
+	       ((M->bbLimit - M->bbOut) - (long)(M->ibuf[m].decode_eip - ds->decode_eip) >
+		BYTES_NEEDED_AT_THE_END)
+#ifdef STATIC_PASS
+	       /* Not across sections of the in-memory image */
+	       && ((M->ibuf[m].mem_decode_eip - ds->mem_decode_eip) ==
+		   (M->ibuf[m].decode_eip - ds->decode_eip))
+#endif
+	       )
+	  m++;
+#endif
+
+      /* The emitters expect M->next_eip just past their instruction.
+	 emit_normal copies everything from ds->decode_eip up to it */
+      M->next_eip = ((m < nInstrs) || decodeFailed) ? M->ibuf[m].decode_eip : run_end;
+
+      DEBUG(show_each_instr_trans) {
+	unsigned long bbno = (M->curr_bb_entry - M->bb_entry_nodes), r;
+	for (r = k; r < m; r++) {
+	  fprintf(DBG, "bb# %lu, ", bbno);
+	  do_disasm(&M->ibuf[r], DBG);
+	}
+	fflush(DBG);
+      }
  
 #ifdef PROFILE_BB_CNT      
-    if(prev_bb_entry != M->curr_bb_entry) {
-      prev_bb_entry = M->curr_bb_entry;
-      inc_emitted = false;
-    }
+      if(prev_bb_entry != M->curr_bb_entry) {
+	prev_bb_entry = M->curr_bb_entry;
+	inc_emitted = false;
+      }
 
-    if(!inc_emitted) {
-      OpCode *p = (OpCode *) ds.pEntry;
-      if((SOURCES_FLAGS(p) == 0) && (MODIFIES_OSZAPF(p))) {
-	bb_emit_lw_inc(M, (unsigned long)&(M->ptState->bb_cnt));
-	inc_emitted = true;
+      if(!inc_emitted) {
+	OpCode *p = (OpCode *) ds->pEntry;
+	if((SOURCES_FLAGS(p) == 0) && (MODIFIES_OSZAPF(p))) {
+	  bb_emit_lw_inc(M, (unsigned long)&(M->ptState->bb_cnt));
+	  inc_emitted = true;
+	}
+	else if(p->attr & DF_BRANCH) {
+	  // BB is about to end
+	  bb_emit_inc(M, (unsigned long)&(M->ptState->bb_cnt));
+	  inc_emitted = true;
+	}      
       }
-      else if(p->attr & DF_BRANCH) {
-	// BB is about to end
-	bb_emit_inc(M, (unsigned long)&(M->ptState->bb_cnt));
-	inc_emitted = true;
-      }      
-    }
 #endif
 
-    unsigned char *begin_bbout = M->bbOut;
+      unsigned char *begin_bbout = M->bbOut;
 #ifdef DEBUG_ON
-    M->nTrInstr++;
+      M->nTrInstr += m - k;
 #endif
 
 #ifdef PROFILE_BB_STATS
-    this_bb_entry->nInstr++;
-    /* Note:  this_bb_entry->src_bb_end_eip MUST be updated before 
-       emitting. This is because, some emitters do change M->next_eip */
-    this_bb_entry->src_bb_end_eip = M->next_eip;
+      this_bb_entry->nInstr += m - k;
+      /* Note:  this_bb_entry->src_bb_end_eip MUST be updated before 
+	 emitting. This is because, some emitters do change M->next_eip */
+      this_bb_entry->src_bb_end_eip = M->next_eip;
 #endif 
 
-    /* Emit the Instruction using the appropriate emitter */
-    isEndOfBB = translate_instr(M, &ds);
+      /* Emit the Instruction(s) using the appropriate emitter */
+#ifdef PROFILE_XLATE_PHASES
+      xp_e = read_timer();
+#endif
+      isEndOfBB = translate_instr(M, ds);
+#ifdef PROFILE_XLATE_PHASES
+      xp_emitter_done(M, ds, m - k, read_timer() - xp_e);
+#endif
     
-    DEBUG(show_each_trans_instr) {
-      unsigned long saved_Meip = M->next_eip;
-      M->next_eip = (unsigned long)begin_bbout;
-      while(M->next_eip < (unsigned long)M->bbOut) {
- 	decode_t dd;
-	do_decode(M, &dd);
-	do_disasm(&dd, DBG);
-	fflush(DBG);
+      DEBUG(show_each_trans_instr) {
+	unsigned long saved_Meip = M->next_eip;
+	M->next_eip = (unsigned long)begin_bbout;
+	while(M->next_eip < (unsigned long)M->bbOut) {
+	  decode_t dd;
+	  do_decode(M, &dd);
+	  do_disasm(&dd, DBG);
+	  fflush(DBG);
+	}
+	M->next_eip = saved_Meip;
+	fprintf(DBG, "\n");
       }
-      M->next_eip = saved_Meip;
-      fprintf(DBG, "\n");
-    }
   
 #ifdef PROFILE_BB_STATS
-    /* Note:  this_bb_entry->trans_bb_end_eip MUST be updated after 
-       emitting, for obvious reasons. */
-    this_bb_entry->trans_bb_end_eip = (unsigned long) M->bbOut;
-    if(this_bb_entry != M->curr_bb_entry) {
-      this_bb_entry->trace_next = M->curr_bb_entry;
-      this_bb_entry = M->curr_bb_entry;
-    }
+      /* Note:  this_bb_entry->trans_bb_end_eip MUST be updated after 
+	 emitting, for obvious reasons. */
+      this_bb_entry->trans_bb_end_eip = (unsigned long) M->bbOut;
+      if(this_bb_entry != M->curr_bb_entry) {
+	this_bb_entry->trace_next = M->curr_bb_entry;
+	this_bb_entry = M->curr_bb_entry;
+      }
 #endif
  
-    if (isEndOfBB)
+      if (isEndOfBB)
+	break;
+    }
+#ifdef PROFILE_XLATE_PHASES
+    xp_t = xp_phase(M, XP_EMIT, xp_t);
+#endif
+
+    if (k < nInstrs)
+      break;
+
+    if (decodeFailed) {
+      decode_t *ds = &M->ibuf[nInstrs];
+
+      DEBUG(decode_eager_panic) 
+	panic ("do_decode failed at instr: %lx byte: %lx\n",
+	       ds->decode_eip, ds->pInstr);
+
+      // Emit a call to panic ...
+      M->next_eip = run_end;
+      bb_emit_byte(M, 0x68u);
+      bb_emit_w32(M, (unsigned long) ds->pInstr);      
+#ifdef NOTE_ADDR_SITES
+      bb_note_site(M, PP_GABS32, M->bbOut - 5, M->bbOut - 4);
+#endif
+      bb_emit_byte(M, 0x68u);
+      bb_emit_w32(M, (unsigned long) M->next_eip);
+#ifdef NOTE_ADDR_SITES
+      bb_note_site(M, PP_GABS32, M->bbOut - 5, M->bbOut - 4);
+#endif
+      bb_emit_call(M, (unsigned char *) panic_decode_fail);      
+      break;
+    }
+
+#ifdef STATIC_PASS
+    if (goingOutofElf)		/* Jump to a library etc, outside of the 
+				   current elf file */
       break;
+#endif
   } /* Grand Translation Loop */
   
   if (!isEndOfBB) {
@@ -1137,6 +1547,9 @@ xlate_bb(machine_t *M)
     M->patch_array[M->patch_count].to = (unsigned char *)M->next_eip;
     M->patch_array[M->patch_count].proc_addr = M->curr_bb_entry->proc_entry;
     M->patch_count ++;
+#ifdef NOTE_SITES
+    bb_note_site(M, PP_JMP, M->bbOut - 5, M->bbOut - 4);
+#endif
   }
 #ifdef PROFILE_BB_STATS
   else {
@@ -1145,6 +1558,13 @@ xlate_bb(machine_t *M)
   }
 #endif
 
+#ifdef PEEPHOLE_OPT
+  peephole_trace(M, trace_start);
+#endif
+#ifdef PROFILE_XLATE_PHASES
+  xp_t = xp_phase(M, XP_EMIT, xp_t);
+#endif
+
 #ifdef STATIC_PASS
   /* I need not emit Patch blocks when statically translating. The
      driver will next add these items to the worklist, and will
@@ -1164,50 +1584,35 @@ xlate_bb(machine_t *M)
     }
   }
 #else
+#if defined(RECYCLE_TRACES) || defined(PERSIST_TRACES) || defined(SPECULATIVE_XLATE)
+  unsigned char *trace_end = M->bbOut;
+#endif
+
   /* Lastly, emit the Patch Blocks */
-  for (i = 0 ; i < M->patch_count ; i ++) {
-    bb_entry *entry = NULL; 
-    unsigned long addr;
-    unsigned long to = (unsigned long)M->patch_array[i].to;
-    unsigned long at = (unsigned long)M->patch_array[i].at;
+  emit_patch_blocks(M);
 
-    entry = lookup_bb_eip (M, to);
-    if ((entry != NULL) && (entry->trans_bb_eip != NOT_YET_TRANSLATED)) {
-      //		if (entry != NULL)
-      DEBUG(xlate_pb) {
-	fprintf(DBG, "1. Patch Block: BB Already found\n");
-	fflush(DBG);
-      }
-      addr = entry->trans_bb_eip;
-      /* If found to be translated already, patch the jump destination right now to implement chaining */
-      tmp = M->bbOut;
-      M->bbOut = (unsigned char *)at;
-      bb_emit_w32(M, addr - (at + 4));
-      M->bbOut = tmp;
-    }
-    else {
-      /* If not, patch the jump destination so that it jumps to its corresponding patch block */
-      tmp = M->bbOut;
-      M->bbOut = (unsigned char *)at;
-      bb_emit_w32(M, tmp - (M->bbOut + 4));
-      M->bbOut = tmp;
-      
-      /* Then, build the patch block */
-      bb_emit_byte (M, 0xE8u);	/* CALL rel32 */
-      bb_emit_w32 (M, (unsigned long) (M->backpatch_and_dispatch_bb - (unsigned long)(M->bbOut + 4)));
-      bb_emit_w32 (M, to);
-      bb_emit_w32 (M, at);
-      if(entry == NULL) {
-	temp_entry = make_bb_entry(M, to, NOT_YET_TRANSLATED, M->patch_array[i].proc_addr);
-      }
-    }
-  }
+#ifdef PERSIST_TRACES
+  ps_note_trace(M, curr_bb_entry, trace_start, trace_end);
+#endif
+#ifdef RECYCLE_TRACES
+  rc_save_trace(M, curr_bb_entry, trace_start, trace_end);
+#endif
+#ifdef SPECULATIVE_XLATE
+  if (M == spec_S)
+    spec_stage_trace(M, curr_bb_entry, trace_start, trace_end);
+#endif
+#endif
+#ifdef PROFILE_XLATE_PHASES
+  xp_phase(M, XP_PATCH, xp_t);
 #endif
 
 #ifdef PROFILE_TRANSLATION
   end_time = read_timer();
   M->ptState->trans_time += (end_time - start_time);
 #endif
+#ifdef PROFILE_XLATE_PHASES
+  xp_trace_done(M, curr_bb_entry->src_bb_eip, xp_instrs, end_time - start_time);
+#endif
 
   return(curr_bb_entry);;   
 }
@@ -1280,19 +1685,32 @@ pt_state thePtState;
 
 #endif
 
-#ifdef TOUCH_RELOADED_BBCACHE_PAGES
+#ifdef SHARED_DUMP_CODE
+/* Map the code of a dump that has just been reloaded from fd over
+   itself, shared and read-only, so that the page cache holds the one
+   copy of it. The page that new code will go on in is left private.
+   The code is in the first section of the dump, which is at the same
+   offset in the file as in M */
 static void
-touch_pages(machine_t *M)
+share_dump_code(machine_t *M, int fd)
 {
-  size_t n;
-  for(n=0; n<450; n++) {
-    size_t ndx = n*PAGE_SIZE + 1;
-    volatile val;
-    val = ((unsigned long *)M->bbCache)[ndx];
-    ((unsigned long *)M->bbCache)[ndx] = val;
-  }
+  unsigned char *lo, *hi;
+
+  dump_shared_range(M, &lo, &hi);
+  M->shared_lo = M->shared_hi = NULL;
+  if (hi <= lo)
+    return;
+
+  if (mmap(lo, hi - lo, PROT_READ | PROT_EXEC, MAP_FIXED | MAP_SHARED, 
+	   fd, lo - (unsigned char *)M) == MAP_FAILED)
+    panic("Sharing the code of the dump failed err = %s", strerror(errno));
+  M->shared_lo = lo;
+  M->shared_hi = hi;
+
+  DEBUG(dump_load)
+    fprintf(DBG, "Sharing %lu bytes of code\n", (unsigned long)(hi - lo));
 }
-#endif /* TOUCH_RELOADED_BBCACHE_PAGES */
+#endif /* SHARED_DUMP_CODE */
 
 
 
@@ -1336,6 +1754,9 @@ init_translator(unsigned long program_start)
 #ifdef PROFILE_BB_STATS
   temp_entry->flags = 0;
 #endif
+#if defined(PERSIST_TRACES) && !defined(STATIC_PASS)
+  ps_load_traces(M);
+#endif
 
 #else /* USE_STATIC_DUMP */
 
@@ -1356,15 +1777,59 @@ init_translator(unsigned long program_start)
 
   size_t mapSize = sizeof(machine_t) + sizeof(pt_state);
   mapSize = mapSize + (mapSize % PAGE_SIZE);    
-  if(fd1 == -1 || fd2 == -1) {
+
+  /* The dump is only used if its header matches this run (see
+     dump_header_ok), and it is never mapped over something that is
+     already at its address */
+  M = MAP_FAILED;
+  if(fd1 != -1 && fd2 != -1) {
+    bb_dump_header h;
+    if((read(fd2, &h, sizeof(h)) == sizeof(h)) && dump_header_ok(&h)) {
+      DEBUG(dump_load)
+	fprintf(DBG, "Came to File-open area of initializer\n");
+
+      M = (machine_t *) mmap(h.M, mapSize, 
+			     PROT_READ | PROT_WRITE | PROT_EXEC,
+			     MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, 0, 0);
+      if(M != MAP_FAILED && M != h.M) {
+	DEBUG(dump_load)
+	  fprintf(DBG, "Cannot map the dump at %lx, starting cold\n", h.M);
+	munmap(M, mapSize);
+	M = MAP_FAILED;
+      }
+      /* Only the sections in the file are mapped from it, the rest of
+	 M stays zero-filled */
+      for(i=0; (M != MAP_FAILED) && (i<h.nsections); i++) {
+	if(mmap(((unsigned char *)M) + h.sections[i].start, h.sections[i].len,
+		PROT_READ | PROT_WRITE | PROT_EXEC,
+		MAP_PRIVATE | MAP_FIXED | MAP_NORESERVE, 
+		fd1, h.sections[i].file_off) == MAP_FAILED) {
+	  DEBUG(dump_load)
+	    fprintf(DBG, "Cannot map section %d of the dump, starting cold\n", i);
+	  munmap(M, mapSize);
+	  M = MAP_FAILED;
+	}
+      }
+#ifdef SHARED_DUMP_CODE
+      if(M != MAP_FAILED)
+	share_dump_code(M, fd1);
+#endif
+    }
+  }
+  if(fd1 != -1)
+    close(fd1);
+  if(fd2 != -1)
+    close(fd2);
+
+  if(M == MAP_FAILED) {
     M = (machine_t *) mmap(0, mapSize, 
 			   PROT_READ | PROT_WRITE | PROT_EXEC,
 			   MAP_ANONYMOUS | MAP_PRIVATE | MAP_NORESERVE, 0, 0);
-    M->ismmaped = true;
-    M->ptState = (pt_state *)(((unsigned char *)M) + sizeof(machine_t));
-
     if(M == MAP_FAILED)
       panic("Allocation of M failed err = %s", strerror(errno));
+
+    M->ismmaped = true;
+    M->ptState = (pt_state *)(((unsigned char *)M) + sizeof(machine_t));
  
     bb_cache_init(M);
     temp_entry = make_bb_entry(M, program_start, NOT_YET_TRANSLATED, 
@@ -1372,31 +1837,16 @@ init_translator(unsigned long program_start)
 #ifdef PROFILE_BB_STATS
     temp_entry->flags = 0;
 #endif
-    M->dump = true;
+    M->ptState->dump = true;
   }
   else {
-    machine_t *maddr;
-    read(fd2, &maddr, sizeof(unsigned char *));
-    close(fd2);
-
-    DEBUG(dump_load)
-      fprintf(DBG, "Came to File-open area of initializer\n");
-    
-    M = (machine_t *) mmap(maddr, mapSize, 
-			   PROT_READ | PROT_WRITE | PROT_EXEC,
-			   MAP_FIXED | MAP_PRIVATE | MAP_NORESERVE, fd1, 0);
-    if(M == MAP_FAILED)
-      panic("Allocation of M at %lx failed err = %s", maddr, strerror(errno));
-    close(fd1);
-    M->dump = false;
+    M->ptState->dump = false;
     M->ismmaped = true;
     M->ptState = (pt_state *)(((unsigned char *)M) + sizeof(machine_t));
 
-#ifdef TOUCH_RELOADED_BBCACHE_PAGES
-    fprintf(DBG, "%lu, %lu\n", (M->bbOut - M->bbCache)/PAGE_SIZE, BBCACHE_SIZE/PAGE_SIZE);
-    fflush(DBG);
-    touch_pages(M);
-#endif /* TOUCH_RELOADED_BBCACHE_PAGES */
+#ifdef PREFETCH_DUMP_PAGES
+    dump_pages_load(M, mapSize, str);
+#endif
   }
 #endif /* USE_STATIC_DUMP main */
   
@@ -1466,6 +1916,14 @@ init_translator(unsigned long program_start)
   end_time = read_timer();
   M->ptState->tot_time = start_time;
   M->ptState->trans_time = (end_time - start_time);  
+  M->ptState->trans_instrs = 0;
+  M->ptState->trans_bytes = 0;
+#ifdef PROFILE_XLATE_PHASES
+  memset(M->ptState->xp_cycles, 0, sizeof(M->ptState->xp_cycles));
+  memset(M->ptState->xp_count, 0, sizeof(M->ptState->xp_count));
+  memset(M->ptState->xp_slowest, 0, sizeof(M->ptState->xp_slowest));
+  M->ptState->xp_nemitters = 0;
+#endif
 #endif  
   return M;
 }
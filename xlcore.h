@@ -57,6 +57,21 @@
 #include <stdlib.h>
 
 #define THIRTY_TWO_BIT_INSTR(d)  ( (d->opstate & OPSTATE_DATA32) ? 0x0001u : 0x0000u )
+
+#define PATCH_BLOCK_LEN 13 /* WARNING: Sensitive to size of Patch-block */
+#define MAX_PATCH_BLOCK_BYTES (PATCH_ARRAY_LEN * PATCH_BLOCK_LEN)
+
+/* Conservative estimate used to determine if there is more room for this BB.
+   Space needed for all patch_blocks + space for at least one instruction 
+   I guess no emitted sequence of instructions per single instruction currently
+   exceeds 64 bytes. If it does, fix the next line */
+#define MAX_BYTES_PER_INSTR 64
+#define BYTES_NEEDED_AT_THE_END (MAX_PATCH_BLOCK_BYTES + MAX_BYTES_PER_INSTR)
+
+#define ROOM_FOR_BB(M) ((M->bbLimit - M->bbOut) > BYTES_NEEDED_AT_THE_END)
+#define MORE_FREE_PATCH_BLOCKS(M) (M->patch_count <= (PATCH_ARRAY_LEN - 4))  /* Leave some extra room for cases like
+										call that need multiple patch_blocks */
+
 bb_entry * xlate_bb(machine_t *M);
 
 /* The only purpose of these macros is to document the role that
@@ -69,6 +84,13 @@ void xlate_for_patch_block(machine_t *M);
 bb_entry *xlate_bb(machine_t *M);
 machine_t *init_translator(unsigned long program_start);
 machine_t *init_thread_trans(unsigned long program_start);
+void xlate_reset(machine_t *M);
+#ifdef PROFILE_XLATE_PHASES
+void xlate_prof_report(machine_t *M, FILE *f);
+#endif
+#ifdef PERSIST_TRACES
+void ps_write_traces(machine_t *M);
+#endif
 machine_t *init_signal_trans(unsigned long program_start, machine_t *parentM);
 
 #endif /* XLCORE_H */